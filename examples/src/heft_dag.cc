@@ -0,0 +1,71 @@
+#include <okec/okec.hpp>
+
+using namespace okec;
+
+// A fork-join pipeline: one source stage, `width` parallel stages and a sink stage.
+void generate_pipeline(okec::task &t, int width, const std::string& group) {
+    okec::workload_generator generator(std::hash<std::string>{}(group));
+    generator.constant("group", group)
+             .uniform("cpu", 0.2, 1.2, 2)
+             .uniform_int("deadline", 10, 99)
+             .uniform("transmission_delay", 0.01, 0.05, 3);
+    generator.generate(t, width + 2);
+
+    auto sink = static_cast<std::size_t>(width) + 1;
+    for (std::size_t i = 1; i < sink; ++i) {
+        t.add_dependency(i, 0);
+        t.add_dependency(sink, i);
+    }
+}
+
+okec::awaitable offloading(auto user, okec::task t) {
+    co_await user->async_send(std::move(t));
+    auto resp = co_await user->async_read();
+    okec::print("{:r}", resp);
+}
+
+int main(int argc, char **argv)
+{
+    log::set_level(log::level::all);
+
+    okec::simulator sim;
+
+    // Create 1 base station
+    okec::base_station_container bs(sim, 1);
+    // Create 5 edge servers
+    okec::edge_device_container edge_servers(sim, 5);
+    // Create 1 user device
+    okec::client_device_container user_devices(sim, 1);
+
+    // Connect the bs and edge servers
+    bs.connect_device(edge_servers);
+
+    // Set the network model for every device
+    okec::multiple_and_single_LAN_WLAN_network_model model;
+    okec::network_initializer(model, user_devices, bs.get(0));
+
+    // Initialize the resources for each edge server.
+    okec::resource_container edge_resources(edge_servers.size());
+    edge_resources.initialize([](auto res) {
+        res->attribute("cpu", okec::rand_range<double>(2.1, 2.2).to_string());
+    });
+
+    // Install each resource on each edge server.
+    edge_servers.install_resources(edge_resources);
+
+    // Set decision engine
+    auto decision_engine = std::make_shared<okec::heft_decision_engine>(&user_devices, &bs);
+    decision_engine->initialize();
+
+    okec::task t;
+    generate_pipeline(t, 8, "pipeline");
+
+    okec::task_graph graph(t);
+    okec::print("critical path: {} elements\n", graph.critical_path([&t](std::size_t i) {
+        return t[i].get_number(okec::task_field::cpu);
+    }).size());
+
+    co_spawn(sim, offloading(user_devices.get_device(0), t));
+
+    sim.run();
+}
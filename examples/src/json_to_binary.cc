@@ -0,0 +1,29 @@
+#include <okec/okec.hpp>
+
+
+// Converts task or resource files written by save_to_file to the binary format.
+// usage: json_to_binary --input=task.json --output=task.bin
+int main(int argc, char **argv)
+{
+    okec::log::set_level(okec::log::level::all);
+
+    std::string input;
+    std::string output;
+
+    ns3::CommandLine cmd;
+    cmd.AddValue("input", "json file written by save_to_file", input);
+    cmd.AddValue("output", "binary file to write", output);
+    cmd.Parse(argc, argv);
+
+    if (input.empty() || output.empty()) {
+        okec::log::error("usage: json_to_binary --input=<json file> --output=<binary file>");
+        return 1;
+    }
+
+    if (!okec::convert_to_binary(input, output)) {
+        okec::log::error("failed to convert {}", input);
+        return 1;
+    }
+
+    okec::log::success("{} --> {}", input, output);
+}
@@ -3,14 +3,11 @@
 using namespace okec;
 
 void generate_task(okec::task &t, int number, const std::string& group) {
-    for ([[maybe_unused]] auto _ : std::views::iota(0, number)) {
-        t.emplace_back({
-            { "task_id", okec::task::unique_id() },
-            { "group", group },
-            { "cpu", okec::rand_range(0.2, 1.2).to_string() },
-            { "deadline", okec::rand_range(10, 100).to_string() },
-        });
-    }
+    okec::workload_generator generator(std::hash<std::string>{}(group));
+    generator.constant("group", group)
+             .uniform("cpu", 0.2, 1.2, 2)
+             .uniform_int("deadline", 10, 99);
+    generator.generate(t, number);
 }
 
 void my_monitor(std::string_view address, std::string_view attr, std::string_view old_val, std::string_view new_val) {
@@ -2,14 +2,11 @@
 
 
 void generate_task(okec::task &t, int number, const std::string& group) {
-    for ([[maybe_unused]] auto _ : std::views::iota(0, number)) {
-        t.emplace_back({
-            { "task_id", okec::task::unique_id() },
-            { "group", group },
-            { "cpu", okec::format("{:.2f}", torch::rand({1}).uniform_(0.2, 1.2).item<double>()) },
-            { "deadline", okec::format("{:.2f}", torch::rand({1}).uniform_(10, 100).item<double>()) },
-        });
-    }
+    okec::workload_generator generator(std::hash<std::string>{}(group));
+    generator.constant("group", group)
+             .uniform("cpu", 0.2, 1.2, 2)
+             .uniform("deadline", 10, 100, 2);
+    generator.generate(t, number);
 
     // t.save_to_file("task-" + std::to_string(number) + ".json");
     // t.load_from_file("task-" + std::to_string(number) + ".json");
@@ -0,0 +1,78 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_HEFT_DECISION_ENGINE_H_
+#define OKEC_HEFT_DECISION_ENGINE_H_
+
+#include <okec/algorithms/decision_engine.h>
+#include <unordered_map>
+
+
+namespace okec
+{
+
+class client_device;
+class client_device_container;
+class edge_device;
+
+
+// Heterogeneous Earliest Finish Time for tasks with dependencies.
+//
+// Elements are ranked by their upward rank, i.e. the length of the critical
+// path from them to the end of the task, and released to the base station
+// once their predecessors have completed. The highest ranked ready element
+// goes to the edge server on which it finishes first.
+class heft_decision_engine : public decision_engine
+{
+    using this_type = heft_decision_engine;
+
+public:
+    heft_decision_engine() = default;
+    heft_decision_engine(client_device_container* clients, base_station_container* base_stations);
+    heft_decision_engine(std::vector<client_device_container>* clients_container, base_station_container* base_stations);
+
+    auto make_decision(const task_element& header) -> result_t override;
+
+    auto local_test(const task_element& header, client_device* client) -> bool override;
+
+    auto prepare(task& t) -> void override;
+
+    auto send(task_element t, std::shared_ptr<client_device> client) -> bool override;
+
+    auto initialize() -> void override;
+
+    auto handle_next() -> void override;
+
+private:
+    auto on_bs_decision_message(base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void;
+
+    auto on_bs_response_message(base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void;
+
+    auto on_es_handling_message(edge_device* es, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void;
+
+    auto on_clients_reponse_message(client_device* client, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void;
+
+private:
+    struct placement {
+        ns3::Ipv4Address ip;
+        double transfer_time; // 结果传给其他设备所需的时间
+        std::size_t pending;  // 尚未分发的后继任务数量，为 0 时移除
+    };
+
+    client_device_container* clients_{};
+    std::vector<client_device_container>* clients_container_{};
+    base_station_container* base_stations_{};
+    std::unordered_map<task_id, placement> placements_;
+};
+
+
+} // namespace okec
+
+#endif // OKEC_HEFT_DECISION_ENGINE_H_
@@ -54,6 +54,10 @@ public:
 
     auto make_decision(const task_element& header) -> result_t override;
 
+    // Worst fit over the edge servers in queue order, deducting the cpu given
+    // to earlier items. Sort-then-fit is the priority queue policy on top.
+    auto make_decisions(std::span<const task_element> items) -> std::vector<result_t> override;
+
     auto local_test(const task_element& header, client_device* client) -> bool override;
 
     auto send(task_element t, std::shared_ptr<client_device> client) -> bool override;
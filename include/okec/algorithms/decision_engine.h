@@ -14,6 +14,13 @@
 #include <okec/common/task.h>
 #include <okec/common/resource.h>
 #include <okec/utils/packet_helper.h>
+#include <functional>
+#include <map>
+#include <optional>
+#include <set>
+#include <span>
+#include <unordered_map>
+#include <vector>
 
 
 namespace okec
@@ -24,8 +31,21 @@ class base_station_container;
 class client_device;
 class edge_device;
 class cloud_server;
+class message;
 
 
+// Typed view of a cached device, kept in step with its json entry.
+struct device_info
+{
+    std::string type; // "es", "cs"
+    ns3::Ipv4Address ip;
+    uint16_t port{};
+    ns3::Vector position;
+    double cpu{};              // reported cpu less the reservations
+    double reserved{};         // cpu of dispatched tasks the device has not acknowledged yet
+    std::uint64_t version{};   // of the last resource report applied
+};
+
 class device_cache
 {
 public:
@@ -37,6 +57,15 @@ public:
     using unary_predicate_type  = std::function<bool(const value_type&)>;
     using binary_predicate_type = std::function<bool(const value_type&, const value_type&)>;
 
+    // Ascending cpu, then descending position, so that the last entry of a
+    // run of equal cpu is the device cached first.
+    struct capacity_order {
+        auto operator()(const std::pair<double, std::size_t>& lhs, const std::pair<double, std::size_t>& rhs) const noexcept -> bool {
+            return lhs.first != rhs.first ? lhs.first < rhs.first : lhs.second > rhs.second;
+        }
+    };
+    using capacity_index = std::set<std::pair<double, std::size_t>, capacity_order>;
+
 public:
 
     auto begin() -> iterator;
@@ -49,6 +78,8 @@ public:
 
     auto data() const -> value_type;
 
+    // Edits made through the json view are not reflected in the typed table
+    // until reindex() is called.
     auto view() -> value_type&;
 
     auto size() const -> std::size_t;
@@ -57,15 +88,58 @@ public:
 
     auto emplace_back(attributes_type values) -> void;
 
+    // Adds a device with the attributes of `r`, or updates the cached device
+    // with the same address. Returns its position.
+    auto insert(const device_info& info, const resource& r) -> std::size_t;
+
+    // Copies the attributes of `r` into the device at `index`. Versioned
+    // reports older than the last one applied are ignored, returning false.
+    auto update(std::size_t index, const resource& r, std::uint64_t version = 0) -> bool;
+    auto update(std::size_t index, double cpu, std::uint64_t version = 0) -> bool;
+
+    // Takes `demand` off the cpu of the device at `index` as soon as a task is
+    // dispatched to it, until the device acknowledges the task.
+    auto reserve(std::size_t index, double demand) -> void;
+    auto release(std::size_t index, double demand) -> void;
+
+    // Position of the device at ip:port, without scanning the cache.
+    auto find(ns3::Ipv4Address ip, uint16_t port) const -> std::optional<std::size_t>;
+
+    auto info(std::size_t index) const -> const device_info&;
+    auto devices() const -> const std::vector<device_info>&;
+
+    // Positions of the devices of a type, e.g. "es", in insertion order.
+    auto devices_of(std::string_view type) const -> const std::vector<std::size_t>&;
+
+    // The device of `type` with the most cpu left (worst fit), or the one with
+    // the least cpu that still covers `demand` (best fit). Ties go to the
+    // device cached first. O(log n), kept up to date by insert() and update().
+    auto worst_fit(std::string_view type) const -> std::optional<std::size_t>;
+    auto best_fit(std::string_view type, double demand) const -> std::optional<std::size_t>;
+
+    // The devices of `type` by cpu left, see capacity_order.
+    auto capacities(std::string_view type) const -> const capacity_index&;
+
     auto find_if(unary_predicate_type pred) -> iterator;
 
     auto sort(binary_predicate_type comp) -> void;
 
+    // Rebuilds the typed table and indexes from the json entries.
+    auto reindex() -> void;
+
 private:
     auto emplace_back(value_type item) -> void;
+    auto index_back() -> void;
+    auto set_cpu(std::size_t index, double cpu) -> void;
+
+    static auto address_key(ns3::Ipv4Address ip, uint16_t port) noexcept -> std::uint64_t;
 
 private:
     value_type cache;
+    std::vector<device_info> infos_;
+    std::unordered_map<std::uint64_t, std::size_t> by_address_;
+    std::map<std::string, std::vector<std::size_t>, std::less<>> by_type_;
+    std::map<std::string, capacity_index, std::less<>> by_capacity_;
 };
 
 
@@ -82,6 +156,51 @@ protected:
         return std::static_pointer_cast<Derived>(this->shared_from_this());
     }
 
+    // Launches a task passed to send() according to the arrival process of the
+    // client. Clients without one get a periodic_arrival(offset, interval).
+    auto launch(client_device* client, const task_element& item, std::function<void()> fn,
+        double offset, double interval) -> void;
+
+    // Sends a decision message carrying `item` from `client` to the decision
+    // device. With decision batching enabled the element is queued instead and
+    // goes out with the other elements of the client's current batch.
+    auto write_decision(client_device* client, const task_element& item) -> void;
+
+    // The elements carried by a decision message, more than one for a batch.
+    static auto decision_elements(ns3::Ptr<ns3::Packet> packet) -> std::vector<task_element>;
+
+    // Sets a ready task no device can take right now aside. It is woken once a
+    // device reports enough free cpu for it.
+    auto park(const task_element& item) -> void;
+
+    // Decides the ready tasks of the decision device and passes each of them to
+    // `dispatch` with its decision, which may be null. `dispatch` dispatches,
+    // parks or erases the task, and returns true if it went out. Tasks are
+    // decided one at a time until one goes out, or all in a single
+    // make_decisions() call in batch mode.
+    auto dispatch_ready(const std::function<bool(task_element&, const result_t&)>& dispatch) -> void;
+
+    // To be called when handle_next() runs out of ready tasks. With nothing in
+    // flight no capacity will be released and no predecessor will complete, so
+    // tasks still parked, or still waiting for a predecessor, after the stall
+    // timeout are answered as failed rather than waiting forever.
+    auto detect_stall() -> void;
+
+    // Answers `item` as failed. Its successors waiting at the decision device
+    // can never run, so they are answered as failed as well.
+    auto reject(const task_element& item) -> void;
+
+    // Takes the cpu of `item` off the device in `target` as soon as it is
+    // dispatched.
+    auto reserve(const task_element& item, const result_t& target) -> void;
+
+    // Edge server side of the reservation: takes the cpu of `item` if enough
+    // is left, and acknowledges it with the next resource report.
+    // Otherwise the base station is sent the current cpu and version, and the
+    // task is decided again.
+    auto acquire(edge_device* es, const task_element& item, ns3::Ipv4Address remote_ip, uint16_t remote_port) -> bool;
+
+    // Bumps the resource version of `es` and reports it, see set_report_batching().
     auto resource_changed(edge_device* es, ns3::Ipv4Address remote_ip, uint16_t remote_port) -> void;
     auto conflict(edge_device* es, const task_element& item, ns3::Ipv4Address remote_ip, uint16_t remote_port) -> void;
 
@@ -95,9 +214,18 @@ public:
     auto initialize_device(base_station_container* bs_container) -> void;
     
     virtual auto make_decision(const task_element& header) -> result_t = 0;
+
+    // Decides several tasks in one pass; result i belongs to items[i] and is null
+    // if no device can take it. By default each task is decided on its own with
+    // make_decision(). Engines that override it take the capacity given to the
+    // earlier items into account.
+    virtual auto make_decisions(std::span<const task_element> items) -> std::vector<result_t>;
     
     virtual auto local_test(const task_element& header, client_device* client) -> bool = 0;
 
+    // Called by a client with the whole task before its elements are passed to send().
+    virtual auto prepare(task& t) -> void {}
+
     virtual auto send(task_element t, std::shared_ptr<client_device> client) -> bool = 0;
 
     virtual auto initialize() -> void = 0;
@@ -108,10 +236,80 @@ public:
 
     auto cache() -> device_cache&;
 
+    // Coalesces the decision messages a client sends within `window` seconds
+    // into packets of at most `max_size` bytes. A window of 0 disables it,
+    // which is the default.
+    auto set_decision_batching(double window, std::uint32_t max_size = 1472) -> void;
+
+    // How long parked tasks may wait with nothing in flight, 2s by default.
+    auto set_stall_timeout(double seconds) -> void;
+
+    // Coalesces the resource reports, and the acknowledgements they carry,
+    // that an edge server sends within `window` seconds into one message. A
+    // window of 0 reports every change at once, which is the default.
+    auto set_report_batching(double window) -> void;
+
+    // In batch mode handle_next() assigns all ready tasks of the base station
+    // with a single make_decisions() call. Off by default.
+    auto set_batch_dispatch(bool enabled) -> void;
+    auto batch_dispatch() const noexcept -> bool;
+
+private:
+    struct decision_batch {
+        task items;
+        std::size_t size = 0; // upper bound of the encoded size
+        ns3::EventId flush_event;
+    };
+
+    auto flush_decisions(client_device* client) -> void;
+
+    // Shared by both initialize_device() overloads.
+    auto cache_edge_devices(base_station_container* bs_container) -> void;
+    auto register_handlers(base_station_container* bs_container) -> void;
+
+    // Wakes the parked tasks that fit on an edge server now, and runs
+    // handle_next() if any task is ready.
+    auto wake_tasks() -> void;
+    auto check_stall() -> void;
+
+    auto report_resource(edge_device* es) -> void;
+
+    // Settles the reservations of the tasks acknowledged in `acks`, or of a
+    // rejected task.
+    auto settle(std::string_view acks) -> void;
+    auto settle(const task_id& id) -> void;
+
+    // Reservation protocol state, see reserve() and acquire().
+    struct device_state {
+        std::uint64_t version = 0;
+        std::vector<std::string> acks; // tasks taken since the last report
+        ns3::Ipv4Address remote_ip;
+        uint16_t remote_port{};
+        ns3::EventId report_event;
+    };
+
+    struct reservation {
+        ns3::Ipv4Address ip;
+        uint16_t port{};
+        double demand{};
+    };
+
 private:
     device_cache m_device_cache;
     std::pair<ns3::Ipv4Address, uint16_t> m_cs_address;
     std::tuple<ns3::Ipv4Address, uint16_t, ns3::Vector> m_cs_info;
+
+    double m_batch_window = 0;
+    std::uint32_t m_batch_size = 1472;
+    std::unordered_map<client_device*, decision_batch> m_decision_batches;
+
+    std::unordered_map<edge_device*, device_state> m_device_states;
+    std::unordered_map<task_id, reservation> m_reservations;
+    double m_report_window = 0;
+
+    double m_stall_timeout = 2.0;
+    bool m_batch_dispatch = false;
+    ns3::EventId m_stall_event;
 };
 
 
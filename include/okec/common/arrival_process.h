@@ -0,0 +1,146 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_ARRIVAL_PROCESS_H_
+#define OKEC_ARRIVAL_PROCESS_H_
+
+#include <okec/common/task.h>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <vector>
+
+
+namespace okec
+{
+
+// Decides when the tasks of a client are launched. Each client owns its own
+// process, see client_device::set_arrival_process.
+class arrival_process
+{
+public:
+    virtual ~arrival_process() = default;
+
+    // Absolute launch time (s) of the next task, `now` being the current
+    // simulation time. std::nullopt holds the task back until another task of
+    // the client completes, then it is asked again.
+    virtual auto next(const task_element& item, double now) -> std::optional<double> = 0;
+
+    // A task of the client has completed at `now`.
+    virtual auto completed(double now) -> void {}
+
+    // Return to the initial state, e.g. between runs or episodes.
+    virtual auto reset() -> void = 0;
+};
+
+
+// The first task `offset` seconds after the first send, then one every
+// `interval` seconds. Starts over once it falls behind the clock.
+class periodic_arrival : public arrival_process
+{
+public:
+    periodic_arrival(double offset, double interval);
+
+    auto next(const task_element& item, double now) -> std::optional<double> override;
+    auto reset() -> void override;
+
+private:
+    double offset_;
+    double interval_;
+    double last_ = -1.0;
+};
+
+
+// Exponential inter-arrival times with `rate` tasks per second.
+class poisson_arrival : public arrival_process
+{
+public:
+    poisson_arrival(double rate, std::uint64_t seed = 0, double start = 0.0);
+
+    auto next(const task_element& item, double now) -> std::optional<double> override;
+    auto reset() -> void override;
+
+private:
+    double rate_;
+    std::uint64_t seed_;
+    double start_;
+    std::mt19937_64 engine_;
+    double last_ = -1.0;
+};
+
+
+// Markov-modulated Poisson process. State i emits tasks at rates[i] and lasts
+// an exponential time with mean sojourn[i], then moves on to state i + 1
+// (cyclically). Two states give the usual bursty on/off source. At least one
+// state needs both a positive rate and a positive sojourn, otherwise the
+// constructor throws std::invalid_argument.
+class mmpp_arrival : public arrival_process
+{
+public:
+    mmpp_arrival(std::vector<double> rates, std::vector<double> sojourn, std::uint64_t seed = 0, double start = 0.0);
+
+    auto next(const task_element& item, double now) -> std::optional<double> override;
+    auto reset() -> void override;
+
+private:
+    auto exponential(double mean) -> double;
+
+private:
+    std::vector<double> rates_;
+    std::vector<double> sojourn_;
+    std::uint64_t seed_;
+    double start_;
+    std::mt19937_64 engine_;
+    std::size_t state_ = 0;
+    double state_end_ = -1.0;
+    double last_ = -1.0;
+};
+
+
+// Replays recorded launch times. Without a trace, the "arrival_time" header
+// attribute of each task is used.
+class trace_arrival : public arrival_process
+{
+public:
+    trace_arrival() = default;
+    explicit trace_arrival(std::vector<double> timestamps);
+
+    auto next(const task_element& item, double now) -> std::optional<double> override;
+    auto reset() -> void override;
+
+private:
+    std::vector<double> timestamps_;
+    std::size_t position_ = 0;
+};
+
+
+// At most `concurrency` tasks in flight. A task is launched `think_time`
+// seconds after a previous one completes; the first ones after `offset`.
+class closed_loop_arrival : public arrival_process
+{
+public:
+    closed_loop_arrival(std::size_t concurrency, double think_time = 0.0, double offset = 0.0);
+
+    auto next(const task_element& item, double now) -> std::optional<double> override;
+    auto completed(double now) -> void override;
+    auto reset() -> void override;
+
+private:
+    std::size_t concurrency_;
+    double think_time_;
+    double offset_;
+    std::size_t in_flight_ = 0;
+    std::size_t launched_ = 0;
+};
+
+
+} // namespace okec
+
+#endif // OKEC_ARRIVAL_PROCESS_H_
@@ -0,0 +1,165 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_ATTRIBUTE_KEY_H_
+#define OKEC_ATTRIBUTE_KEY_H_
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+
+namespace okec
+{
+
+// Well-known task header attributes. They are kept in typed columns, while
+// every other attribute falls back to a per-element key/value list.
+enum class task_field : std::uint8_t {
+    // id column
+    task_id,
+
+    // text columns
+    group,
+    from_ip,
+
+    // numeric columns
+    cpu,
+    deadline,
+    size,
+    status,
+    from_port,
+    arrival_time,
+    transmission_delay,
+
+    count
+};
+
+inline constexpr std::array<std::string_view, std::to_underlying(task_field::count)> task_field_names {
+    "task_id", "group", "from_ip",
+    "cpu", "deadline", "size", "status", "from_port", "arrival_time", "transmission_delay"
+};
+
+inline constexpr auto is_text_field(task_field field) noexcept -> bool {
+    return field == task_field::group || field == task_field::from_ip;
+}
+
+inline constexpr auto is_numeric_field(task_field field) noexcept -> bool {
+    return field >= task_field::cpu && field < task_field::count;
+}
+
+
+// The name of an attribute, resolved once: keys of the well-known attributes
+// know their task_field, so lookups with them skip all name comparisons, and
+// the hash is computed up front. Keys built from literals are resolved at
+// compile time, see okec::keys for the built-in ones.
+//
+// A key only views its name. intern() keeps a copy alive for keys built from
+// temporary strings.
+class attribute_key
+{
+public:
+    constexpr attribute_key(task_field field) noexcept
+        : name_{ task_field_names[std::to_underlying(field)] }
+        , field_{ field }
+        , hash_{ hash_of(name_) }
+    {}
+
+    constexpr attribute_key(std::string_view name) noexcept
+        : name_{ name }
+        , field_{ resolve(name) }
+        , hash_{ hash_of(name) }
+    {}
+
+    constexpr attribute_key(const char* name) noexcept
+        : attribute_key(std::string_view(name))
+    {}
+
+    attribute_key(const std::string& name) noexcept
+        : attribute_key(std::string_view(name))
+    {}
+
+    constexpr auto name() const noexcept -> std::string_view { return name_; }
+    constexpr auto field() const noexcept -> std::optional<task_field> { return field_; }
+    constexpr auto hash() const noexcept -> std::size_t { return hash_; }
+
+    constexpr auto is(task_field field) const noexcept -> bool { return field_ == field; }
+
+    constexpr operator std::string_view() const noexcept { return name_; }
+
+    friend constexpr auto operator==(const attribute_key& lhs, const attribute_key& rhs) noexcept -> bool {
+        return lhs.hash_ == rhs.hash_ && lhs.name_ == rhs.name_;
+    }
+
+    // A key whose name lives as long as the program.
+    static auto intern(std::string_view name) -> attribute_key;
+
+    static constexpr auto resolve(std::string_view name) noexcept -> std::optional<task_field> {
+        for (std::size_t i = 0; i < task_field_names.size(); ++i) {
+            if (task_field_names[i] == name)
+                return static_cast<task_field>(i);
+        }
+
+        return std::nullopt;
+    }
+
+    static constexpr auto hash_of(std::string_view name) noexcept -> std::size_t {
+        return static_cast<std::size_t>(fnv1a(name));
+    }
+
+    // 64-bit FNV-1a, the same on every platform
+    static constexpr auto fnv1a(std::string_view text) noexcept -> std::uint64_t {
+        std::uint64_t hash = 0xcbf29ce484222325ull;
+        for (unsigned char c : text) {
+            hash ^= c;
+            hash *= 0x100000001b3ull;
+        }
+
+        return hash;
+    }
+
+private:
+    std::string_view name_;
+    std::optional<task_field> field_;
+    std::size_t hash_;
+};
+
+
+namespace keys {
+
+inline constexpr attribute_key task_id            { task_field::task_id };
+inline constexpr attribute_key group              { task_field::group };
+inline constexpr attribute_key from_ip            { task_field::from_ip };
+inline constexpr attribute_key cpu                { task_field::cpu };
+inline constexpr attribute_key deadline           { task_field::deadline };
+inline constexpr attribute_key size               { task_field::size };
+inline constexpr attribute_key status             { task_field::status };
+inline constexpr attribute_key from_port          { task_field::from_port };
+inline constexpr attribute_key arrival_time       { task_field::arrival_time };
+inline constexpr attribute_key transmission_delay { task_field::transmission_delay };
+
+} // namespace keys
+
+
+} // namespace okec
+
+
+template <>
+struct std::hash<okec::attribute_key>
+{
+    auto operator()(const okec::attribute_key& key) const noexcept -> std::size_t {
+        return key.hash();
+    }
+};
+
+#endif // OKEC_ATTRIBUTE_KEY_H_
@@ -11,9 +11,11 @@
 #ifndef OKEC_MESSAGE_H_
 #define OKEC_MESSAGE_H_
 
+#include <okec/common/message_type.h>
 #include <okec/common/response.h>
 #include <okec/common/resource.h>
 #include <okec/common/task.h>
+#include <okec/utils/arena.h>
 #include <nlohmann/json.hpp>
 #include <string_view>
 
@@ -63,25 +65,16 @@ public:
         return result;
     }
 
-    operator json&() { return j_; }
+    operator arena_json&() { return j_; }
 
     auto valid() -> bool;
 
 private:
-    json j_;
+    // Allocated from the message arena while a packet is being handled.
+    arena_json j_;
 };
 
 
-inline constexpr std::string_view message_resource_changed { "resource_changed" };
-inline constexpr std::string_view message_response { "response" };
-inline constexpr std::string_view message_handling { "handling" };
-inline constexpr std::string_view message_dispatching { "dispatching" };
-inline constexpr std::string_view message_get_resource_information { "get_resource_information" };
-inline constexpr std::string_view message_resource_information { "resource_information" };
-inline constexpr std::string_view message_decision { "decision" };
-inline constexpr std::string_view message_conflict { "conflict" };
-// inline constexpr std::string_view 
-
 } // namespace okec
 
 #endif // OKEC_MESSAGE_H_
\ No newline at end of file
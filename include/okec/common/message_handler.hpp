@@ -11,7 +11,9 @@
 #ifndef OKEC_MESSAGE_HANDLER_H_
 #define OKEC_MESSAGE_HANDLER_H_
 
+#include <okec/common/message_type.h>
 #include <okec/utils/delegate.hpp>
+#include <array>
 #include <functional>
 #include <string>
 
@@ -19,27 +21,54 @@
 namespace okec
 {
 
+// Built-in message types are looked up in a flat table indexed by their
+// message_kind, user-defined types by name. The first handler registered
+// for a type is kept.
 template <typename CallbackType = std::function<void()>>
 class message_handler {
-	using delegate_type = utils::delegate<std::string_view, CallbackType>;
+	using delegate_type = utils::delegate<std::string, CallbackType, std::less<>>;
+	using table_type    = std::array<CallbackType, std::to_underlying(message_kind::count)>;
 
 public:
 	auto add_handler(std::string_view msg_type, CallbackType callback) -> void {
-		delegate_.insert(msg_type, callback);
+		if (auto kind = message_kind_of(msg_type); kind != message_kind::user)
+			add_handler(kind, std::move(callback));
+		else
+			delegate_.insert(std::string(msg_type), std::move(callback));
+	}
+
+	auto add_handler(message_kind kind, CallbackType callback) -> void {
+		auto& slot = table_[std::to_underlying(kind)];
+		if (!slot)
+			slot = std::move(callback);
 	}
 
 	template <typename... Args>
-	auto dispatch(const std::string& msg_type, Args... args) -> bool {
+	auto dispatch(message_kind kind, Args&&... args) -> bool {
+		auto& slot = table_[std::to_underlying(kind)];
+		if (kind == message_kind::user || !slot)
+			return false;
+
+		slot(std::forward<Args>(args)...);
+		return true;
+	}
+
+	template <typename... Args>
+	auto dispatch(std::string_view msg_type, Args&&... args) -> bool {
+		if (auto kind = message_kind_of(msg_type); kind != message_kind::user)
+			return dispatch(kind, std::forward<Args>(args)...);
+
 		typename delegate_type::value_type::const_iterator iter;
 		bool ret = delegate_.find(msg_type, iter);
 		if (ret) {
-			iter->second(args...);
+			iter->second(std::forward<Args>(args)...);
 		}
 
 		return ret;
 	}
 
 private:
+	table_type table_{};
 	delegate_type delegate_;
 };
 
@@ -0,0 +1,81 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_MESSAGE_TYPE_H_
+#define OKEC_MESSAGE_TYPE_H_
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+
+namespace okec
+{
+
+inline constexpr std::string_view message_resource_changed { "resource_changed" };
+inline constexpr std::string_view message_response { "response" };
+inline constexpr std::string_view message_handling { "handling" };
+inline constexpr std::string_view message_dispatching { "dispatching" };
+inline constexpr std::string_view message_get_resource_information { "get_resource_information" };
+inline constexpr std::string_view message_resource_information { "resource_information" };
+inline constexpr std::string_view message_decision { "decision" };
+inline constexpr std::string_view message_conflict { "conflict" };
+// inline constexpr std::string_view 
+
+// Compile-time ids of the built-in message types, carried in the
+// message_header. User-defined types are `user` and are routed by name.
+enum class message_kind : std::uint16_t {
+    user,
+    resource_changed,
+    response,
+    handling,
+    dispatching,
+    get_resource_information,
+    resource_information,
+    decision,
+    conflict,
+
+    count
+};
+
+inline constexpr std::array<std::string_view, std::to_underlying(message_kind::count)> message_kind_names {
+    std::string_view{},
+    message_resource_changed,
+    message_response,
+    message_handling,
+    message_dispatching,
+    message_get_resource_information,
+    message_resource_information,
+    message_decision,
+    message_conflict
+};
+
+inline constexpr auto message_kind_of(std::string_view type) noexcept -> message_kind {
+    for (std::size_t i = 1; i < message_kind_names.size(); ++i) {
+        if (message_kind_names[i] == type)
+            return static_cast<message_kind>(i);
+    }
+
+    return message_kind::user;
+}
+
+// Empty for user-defined types.
+inline constexpr auto message_kind_name(message_kind kind) noexcept -> std::string_view {
+    auto index = std::to_underlying(kind);
+    return index < message_kind_names.size() ? message_kind_names[index] : std::string_view{};
+}
+
+static_assert(message_kind_of(message_conflict) == message_kind::conflict);
+
+
+} // namespace okec
+
+#endif // OKEC_MESSAGE_TYPE_H_
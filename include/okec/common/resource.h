@@ -14,12 +14,21 @@
 #include <okec/utils/packet_helper.h>
 #include <ns3/core-module.h>
 #include <ns3/node-container.h>
+#include <cmath>
 
 
 
 namespace okec
 {
 
+// Devices store their cpu as text with 6 decimal places. Values computed
+// from it are rounded the same way before they are stored or planned with,
+// so a decision engine tracking cpu as double agrees with the devices.
+inline auto round_cpu(double cpu) noexcept -> double
+{
+    return std::round(cpu * 1e6) / 1e6;
+}
+
 
 class resource : public ns3::Object
 {
@@ -111,8 +120,12 @@ public:
     auto trace_resource() -> void;
 
     auto save_to_file(const std::string& file) -> void;
+
+    // Loads a json file written by save_to_file or a binary one written by save_to_binary_file.
     auto load_from_file(const std::string& file) -> bool;
 
+    auto save_to_binary_file(const std::string& file) const -> bool;
+
     auto set_monitor(resource::monitor_type monitor) -> void;
 
 private:
@@ -11,9 +11,12 @@
 #ifndef OKEC_RESPONSE_H_
 #define OKEC_RESPONSE_H_
 
+#include <okec/common/task_id.h>
 #include <okec/utils/packet_helper.h>
 #include <functional>
+#include <optional>
 #include <string>
+#include <unordered_map>
 
 
 namespace okec
@@ -67,6 +70,44 @@ private:
 };
 
 
+// The records of the tasks a client has sent, held per group until every task
+// of the group has been answered. Records are found by task id in O(1).
+class response_tracker {
+public:
+    using attributes_type = response::attributes_type;
+    using value_type      = response::value_type;
+
+public:
+    // Adds the record of a task. `values` must hold its "task_id" and "group".
+    auto expect(attributes_type values) -> void;
+
+    // The record of a task not answered yet, nullptr if there is none.
+    auto find(std::string_view task_id) -> value_type*;
+
+    // Marks a task answered. Once its whole group is, the records of the group
+    // are returned and no longer held.
+    auto complete(std::string_view task_id) -> std::optional<response>;
+
+    // Number of records held.
+    auto size() const noexcept -> std::size_t;
+
+private:
+    struct group_type {
+        response records;
+        std::size_t unfinished{};
+    };
+
+    struct record_type {
+        std::string group;
+        std::size_t index; // in group_type::records
+    };
+
+    std::unordered_map<std::string, group_type> groups_;
+    std::unordered_map<task_id, record_type> records_;
+    std::size_t size_{};
+};
+
+
 } // namespace okec
 
 #endif // OKEC_RESPONSE_H_
\ No newline at end of file
@@ -11,29 +11,47 @@
 #ifndef OKEC_TASK_H_
 #define OKEC_TASK_H_
 
+#include <okec/common/task_store.h>
 #include <okec/utils/packet_helper.h>
+#include <memory>
 #include <string>
 
 
 namespace okec
 {
 
+// A handle to one element of a task.
+//
+// Handles obtained from task::elements_view() or task::at() refer to the task
+// itself and write through to it. All other handles share their storage and
+// are copy-on-write: copying them is cheap, and a write only copies the
+// element if the storage is still shared with another handle.
 class task_element
 {
+    friend class task;
+
 public:
-    task_element(json* item) noexcept;
-    task_element(json item) noexcept;
+    task_element(std::nullptr_t = nullptr) noexcept;
+    task_element(const json& item) noexcept;
+    task_element(task_store* store, std::size_t index) noexcept; // ref
     task_element(const task_element& other) noexcept;
     task_element& operator=(const task_element& other) noexcept;
     task_element(task_element&& other) noexcept;
     task_element& operator=(task_element&& other) noexcept;
     ~task_element();
 
-    auto get_header(const std::string& key) const -> std::string;
-    auto set_header(std::string_view key, std::string_view value) -> bool;
+    auto get_header(attribute_key key) const -> std::string;
+    auto set_header(attribute_key key, std::string_view value) -> bool;
+
+    auto get_body(attribute_key key) const -> std::string;
+    auto set_body(attribute_key key, std::string_view value) -> bool;
 
-    auto get_body(const std::string& key) const -> std::string;
-    auto set_body(std::string_view key, std::string_view value) -> bool;
+    auto get_id() const -> task_id;
+    auto set_id(task_id id) -> bool;
+
+    // Typed access to the well-known header attributes, no string parsing involved.
+    auto get_number(task_field field) const -> double;
+    auto set_number(task_field field, double value) -> bool;
 
     auto j_data() const -> json;
 
@@ -43,9 +61,18 @@ public:
 
     auto dump(int indent = -1) const -> std::string;
 
+    // Number of handles sharing the storage of this element, 0 for references.
+    auto use_count() const noexcept -> long;
+
+private:
+    task_element(std::shared_ptr<task_store> store, std::size_t index) noexcept; // shared
+
+    auto detach() -> void;
+
 private:
-    json* elem_;
-    bool is_dynamically_allocated;
+    task_store* store_;
+    std::size_t index_;
+    std::shared_ptr<task_store> owned_;
 };
 
 class task : public ns3::SimpleRefCount<task>
@@ -67,6 +94,9 @@ public:
     static auto from_msg_packet(ns3::Ptr<ns3::Packet> packet) -> task;
 
     auto emplace_back(task_header, task_body = {}) -> void;
+
+    // Append a copy of an element.
+    auto push_back(const task_element& item) -> void;
     
     auto dump(int indent = -1) const -> std::string;
 
@@ -86,7 +116,13 @@ public:
 
     auto empty() -> bool;
 
-    auto set_if(attributes_t values, auto f) -> void;
+    template <typename F>
+    auto set_if(attributes_t values, F f) -> void {
+        if (auto index = this->first_match(values)) {
+            auto item = this->at(*index);
+            f(item);
+        }
+    }
 
     auto find_if(attributes_t values) -> task;
     auto find_if(attribute_t value) -> task;
@@ -94,22 +130,42 @@ public:
     auto contains(attributes_t values) -> bool;
     auto contains(attribute_t value) -> bool;
 
-    static auto get_header(const json& element, const std::string& key) -> std::string;
-    static auto get_body(const json& element, const std::string& key) -> std::string;
+    // Keep a hash index on a header attribute so that find_if, contains and
+    // set_if on it no longer scan every element.
+    auto create_index(attribute_key key) -> void;
+
+    // The first element whose status is "0", or an empty element if there is none.
+    auto next_pending() noexcept -> task_element;
+
+    // Element `successor` may only start once element `predecessor` has completed.
+    // See task_graph for the resulting dependency graph.
+    auto add_dependency(std::size_t successor, std::size_t predecessor) -> void;
+
+    static auto get_header(const json& element, attribute_key key) -> std::string;
+    static auto get_body(const json& element, attribute_key key) -> std::string;
 
     static auto unique_id() -> std::string;
 
     auto save_to_file(const std::string& file_name) -> void;
+
+    // Loads a json file written by save_to_file or a binary one written by save_to_binary_file.
     auto load_from_file(const std::string& file_name) -> bool;
 
+    auto save_to_binary_file(const std::string& file_name) const -> bool;
+
     auto operator[](std::size_t index) noexcept -> task_element;
     auto operator[](std::size_t index) const noexcept -> task_element;
 
+    auto store() noexcept -> task_store&;
+    auto store() const noexcept -> const task_store&;
+
 private:
-    auto push_back(const json& sub) -> void;
+    auto match(std::size_t index, attributes_t values) const -> bool;
+    auto candidates(attributes_t values) const -> const task_store::bucket_type*;
+    auto first_match(attributes_t values) const -> std::optional<std::size_t>;
 
 private:
-    json m_task;
+    task_store m_store;
 };
 
 
@@ -0,0 +1,115 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_TASK_GRAPH_H_
+#define OKEC_TASK_GRAPH_H_
+
+#include <okec/common/task.h>
+#include <okec/common/task_queue.h>
+#include <functional>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+
+namespace okec
+{
+
+// An element lists the ids of its predecessors in this header attribute,
+// separated by commas. See task::add_dependency.
+inline constexpr std::string_view dependency_key { "depends_on" };
+
+// Predecessor ids of an element.
+auto dependencies_of(const task_element& item) -> std::vector<task_id>;
+
+
+// The dependency graph between the elements of a task. Dependencies on ids
+// that are not part of the task are left out of the graph.
+class task_graph
+{
+public:
+    using cost_type = std::function<double(std::size_t)>;
+    using edge_cost_type = std::function<double(std::size_t, std::size_t)>;
+
+public:
+    explicit task_graph(const task& t);
+
+    auto size() const noexcept -> std::size_t;
+
+    auto predecessors(std::size_t index) const -> const std::vector<std::size_t>&;
+    auto successors(std::size_t index) const -> const std::vector<std::size_t>&;
+
+    auto is_acyclic() const noexcept -> bool;
+
+    // Element indexes, every element after its predecessors. Empty if there is a cycle.
+    auto topological_order() const -> const std::vector<std::size_t>&;
+
+    // HEFT upward ranks: rank(i) = cost(i) + max over successors j of (comm(i, j) + rank(j)).
+    auto upward_ranks(cost_type cost, edge_cost_type comm = {}) const -> std::vector<double>;
+
+    // The most expensive path from an entry to an exit element.
+    auto critical_path(cost_type cost, edge_cost_type comm = {}) const -> std::vector<std::size_t>;
+
+private:
+    std::vector<std::vector<std::size_t>> predecessors_;
+    std::vector<std::vector<std::size_t>> successors_;
+    std::vector<std::size_t> order_;
+};
+
+
+// Holds elements back until all of their predecessors have completed.
+class dependency_tracker
+{
+public:
+    // Pushes `item` to `ready` if its predecessors have completed, keeps it otherwise.
+    // If a predecessor has failed, or `item` closes a cycle of waiting elements,
+    // `item` fails and is handed back.
+    auto submit(task_element item, task_queue& ready) -> std::optional<task_element>;
+
+    // Marks `id` as completed and pushes the elements released by it to `ready`.
+    // Returns the number of released elements.
+    auto complete(const task_id& id, task_queue& ready) -> std::size_t;
+
+    // Marks `id` as failed. Elements waiting for it, directly or through other
+    // waiting elements, can never run; they fail too and are returned.
+    auto fail(const task_id& id) -> std::vector<task_element>;
+
+    // Fails the elements still waiting, e.g. for a predecessor that was never
+    // submitted, and returns them.
+    auto take_waiting() -> std::vector<task_element>;
+
+    auto is_completed(const task_id& id) const -> bool;
+    auto is_failed(const task_id& id) const -> bool;
+
+    // Number of elements still waiting for a predecessor.
+    auto waiting() const noexcept -> std::size_t;
+
+    auto clear() -> void;
+
+private:
+    auto closes_cycle(const task_id& id, const std::vector<task_id>& predecessors) const -> bool;
+
+private:
+    struct waiting_item {
+        task_element item;
+        std::size_t unmet;
+    };
+
+    std::unordered_set<task_id> completed_;
+    std::unordered_set<task_id> failed_;
+    std::unordered_map<task_id, waiting_item> waiting_;
+    std::unordered_map<task_id, std::vector<task_id>> successors_; // predecessor -> waiting elements
+};
+
+
+} // namespace okec
+
+#endif // OKEC_TASK_GRAPH_H_
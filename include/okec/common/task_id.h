@@ -0,0 +1,71 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_TASK_ID_H_
+#define OKEC_TASK_ID_H_
+
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+
+namespace okec
+{
+
+// 128-bit task identifier. Ids are compared and hashed as integers, the
+// 32-digit hex form only shows up when a task is exported.
+class task_id
+{
+public:
+    constexpr task_id() noexcept = default;
+    constexpr task_id(std::uint64_t high, std::uint64_t low) noexcept
+        : high_{ high }, low_{ low } {}
+
+    // Draw a new id from a fast 64-bit PRNG.
+    static auto generate() -> task_id;
+
+    // Reseed the generator so that runs become reproducible.
+    static auto seed(std::uint64_t value) -> void;
+
+    // Canonical ids (32 uppercase hex digits) are parsed, any other text is
+    // hashed so that user-defined ids still compare as integers.
+    static auto from_string(std::string_view sv) noexcept -> task_id;
+
+    // Returns true if `sv` is the canonical form of some id.
+    static auto is_canonical(std::string_view sv) noexcept -> bool;
+
+    auto to_string() const -> std::string;
+
+    constexpr auto high() const noexcept -> std::uint64_t { return high_; }
+    constexpr auto low() const noexcept -> std::uint64_t { return low_; }
+
+    friend constexpr auto operator==(const task_id&, const task_id&) noexcept -> bool = default;
+    friend constexpr auto operator<=>(const task_id&, const task_id&) noexcept = default;
+
+private:
+    std::uint64_t high_{};
+    std::uint64_t low_{};
+};
+
+
+} // namespace okec
+
+
+template <>
+struct std::hash<okec::task_id> {
+    auto operator()(const okec::task_id& id) const noexcept -> std::size_t {
+        // The bits are random already, folding the halves is enough.
+        return static_cast<std::size_t>(id.high() ^ (id.low() * 0x9E3779B97F4A7C15ull));
+    }
+};
+
+#endif // OKEC_TASK_ID_H_
@@ -0,0 +1,119 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_TASK_QUEUE_H_
+#define OKEC_TASK_QUEUE_H_
+
+#include <okec/common/task.h>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+namespace okec
+{
+
+enum class queue_policy
+{
+    fifo,     // arrival order
+    edf,      // earliest absolute deadline, i.e. arrival_time + deadline
+    priority  // highest priority first, see task_queue::set_policy
+};
+
+
+// The tasks held by a base station: the ready ones in dispatch order, the
+// parked ones waiting for capacity, and the ones in flight. Every task is found
+// by its id in O(1), so dispatching and completing a task never scans the
+// queue. Ties keep the arrival order.
+class task_queue
+{
+public:
+    using priority_type = std::function<double(const task_element&)>;
+
+public:
+    task_queue(queue_policy policy = queue_policy::fifo);
+
+    // Reorders the ready tasks. `priority` is required by queue_policy::priority.
+    auto set_policy(queue_policy policy, priority_type priority = {}) -> void;
+    auto policy() const noexcept -> queue_policy;
+
+    // Adds a ready task. A task without an id is given a new one. Returns false,
+    // leaving the queue as it is, if a task with the same id is already held;
+    // a task in flight goes back through requeue() instead.
+    auto push(task_element item) -> bool;
+
+    // The next task to dispatch, nullptr if none is ready.
+    auto front() noexcept -> task_element*;
+
+    // All ready tasks in dispatch order.
+    auto ready_items() -> std::vector<task_element*>;
+
+    // Moves a ready task in flight and sets its status to 1.
+    auto dispatch(const task_id& id) -> bool;
+
+    // Puts a task in flight back to its place in the ready queue, status 0.
+    auto requeue(const task_id& id) -> bool;
+
+    // Sets a ready task aside until at least `demand` of capacity is free.
+    auto park(const task_id& id, double demand) -> bool;
+
+    // Returns the parked tasks whose demand fits in `capacity` to their place
+    // in the ready queue. Returns how many were woken.
+    auto wake(double capacity) -> std::size_t;
+
+    // Removes the parked tasks and returns them in demand order.
+    auto take_parked() -> std::vector<task_element>;
+
+    // Removes a task, ready or in flight.
+    auto erase(const task_id& id) -> std::optional<task_element>;
+
+    auto find(const task_id& id) noexcept -> task_element*;
+
+    auto size() const noexcept -> std::size_t;
+    auto empty() const noexcept -> bool;
+    auto ready() const noexcept -> std::size_t;
+    auto parked() const noexcept -> std::size_t;
+    auto in_flight() const noexcept -> std::size_t;
+
+    auto clear() -> void;
+
+private:
+    using order_key = std::pair<double, std::uint64_t>; // (key, arrival sequence)
+
+    using park_key  = std::pair<double, order_key>;      // (demand, order)
+
+    enum class state : std::uint8_t { ready, parked, in_flight };
+
+    struct entry {
+        task_element item;
+        order_key order;
+        state where;
+        double demand;
+    };
+
+    auto key_of(const task_element& item) const -> double;
+
+private:
+    queue_policy policy_;
+    priority_type priority_;
+    std::uint64_t sequence_{};
+    std::unordered_map<task_id, entry> tasks_;
+    std::map<order_key, task_id> ready_;
+    std::map<park_key, task_id> parked_;
+};
+
+
+} // namespace okec
+
+#endif // OKEC_TASK_QUEUE_H_
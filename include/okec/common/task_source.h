@@ -0,0 +1,94 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_TASK_SOURCE_H_
+#define OKEC_TASK_SOURCE_H_
+
+#include <okec/common/task.h>
+#include <okec/utils/binary_table.h>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+
+namespace okec
+{
+
+// A pull-based supply of task elements. Sources are read in chunks, so a
+// workload never has to be held in memory all at once.
+class task_source
+{
+public:
+    virtual ~task_source() = default;
+
+    // Appends at most `n` elements to `t` and returns how many were appended.
+    // Fewer than `n` means the source is exhausted.
+    virtual auto read(task& t, std::size_t n) -> std::size_t = 0;
+};
+
+
+// One element per line: { "header": {...}, "body": {...} }
+// Blank lines are skipped.
+class ndjson_task_source : public task_source
+{
+public:
+    explicit ndjson_task_source(const std::string& file_name);
+
+    auto is_open() const -> bool;
+
+    auto read(task& t, std::size_t n) -> std::size_t override;
+
+private:
+    std::ifstream m_file;
+};
+
+
+// Rows of a binary task file (see binary_table), read in place from the
+// mapped file. Only the rows of the current chunk are copied into the task.
+class binary_task_source : public task_source
+{
+public:
+    explicit binary_task_source(const std::string& file_name);
+
+    // False if the file is missing, not a task table or has unknown columns.
+    auto is_open() const -> bool;
+
+    auto rows() const noexcept -> std::size_t;
+
+    auto read(task& t, std::size_t n) -> std::size_t override;
+
+private:
+    binary_table m_table;
+    std::vector<std::optional<task_field>> m_fields; // numeric columns only
+    std::size_t m_row{};
+    bool m_valid{};
+};
+
+
+// Elements produced by a callback. An empty element ends the source.
+class generator_task_source : public task_source
+{
+public:
+    using generator_type = std::function<task_element()>;
+
+    explicit generator_task_source(generator_type generator);
+
+    auto read(task& t, std::size_t n) -> std::size_t override;
+
+private:
+    generator_type m_generator;
+};
+
+
+} // namespace okec
+
+#endif // OKEC_TASK_SOURCE_H_
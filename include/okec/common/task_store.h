@@ -0,0 +1,133 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_TASK_STORE_H_
+#define OKEC_TASK_STORE_H_
+
+#include <okec/common/attribute_key.h>
+#include <okec/common/task_id.h>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+
+namespace okec
+{
+
+// Struct-of-arrays storage for the elements of a task.
+class task_store
+{
+public:
+    using size_type       = std::size_t;
+    using attribute_type  = std::pair<std::string, std::string>;
+    using attributes_type = std::vector<attribute_type>;
+    using bucket_type     = std::set<size_type>;
+    using index_type      = std::unordered_map<std::string, bucket_type>;
+
+public:
+    auto size() const noexcept -> size_type;
+    auto empty() const noexcept -> bool;
+    auto reserve(size_type n) -> void;
+    auto clear() -> void;
+
+    // Append an empty element and return its index.
+    auto push_back() -> size_type;
+
+    // Append `n` empty elements and return the index of the first one.
+    auto append(size_type n) -> size_type;
+
+    // Append a copy of the element `index` of `other`.
+    auto push_back(const task_store& other, size_type index) -> size_type;
+
+    // Append an element from its json form: { "header": {...}, "body": {...} }
+    auto push_back(const json& item) -> size_type;
+
+    auto get_header(size_type index, attribute_key key) const -> std::string;
+    auto set_header(size_type index, attribute_key key, std::string_view value) -> void;
+
+    auto get_body(size_type index, attribute_key key) const -> std::string;
+    auto set_body(size_type index, attribute_key key, std::string_view value) -> void;
+
+    auto contains(size_type index, task_field field) const -> bool;
+
+    // User-defined attributes of an element, i.e. everything not kept in a column.
+    auto headers(size_type index) const -> const attributes_type&;
+    auto bodies(size_type index) const -> const attributes_type&;
+
+    // Returns the integer id of an element. Ids that were given in a non-canonical
+    // form are hashed, see task_id::from_string.
+    auto get_id(size_type index) const -> task_id;
+    auto set_id(size_type index, task_id id) -> void;
+
+    auto get_text(size_type index, task_field field) const -> const std::string&;
+    auto get_number(size_type index, task_field field) const -> double;
+    auto set_number(size_type index, task_field field, double value) -> void;
+
+    auto to_json(size_type index) const -> json;
+
+    // Secondary indexes on header attributes, kept up to date on every write.
+    auto create_index(attribute_key key) -> void;
+    auto has_index(attribute_key key) const noexcept -> bool;
+
+    // Elements whose header `key` equals `value`, in ascending order.
+    // Returns nullptr if `key` is not indexed.
+    auto lookup(attribute_key key, std::string_view value) const -> const bucket_type*;
+
+    // Elements whose status is 0, i.e. not handled yet. Always maintained.
+    auto pending() const noexcept -> const bucket_type&;
+
+    static auto field_of(std::string_view key) noexcept -> std::optional<task_field>;
+
+    static auto format_number(double value) -> std::string;
+
+private:
+    auto set_present(size_type index, task_field field, bool present) -> void;
+    auto write_header(size_type index, attribute_key key, std::string_view value) -> void;
+
+    auto find_index(attribute_key key) -> index_type*;
+    auto index_row(size_type index) -> void;
+    auto update_pending(size_type index) -> void;
+    static auto unindex(index_type& idx, size_type index, const std::string& value) -> void;
+
+    static auto text_column(task_field field) noexcept -> std::size_t;
+    static auto number_column(task_field field) noexcept -> std::size_t;
+
+    static auto find(const attributes_type& attrs, std::string_view key) -> const attribute_type*;
+    static auto assign(attributes_type& attrs, std::string_view key, std::string_view value) -> void;
+    static auto erase(attributes_type& attrs, std::string_view key) -> void;
+
+private:
+    static constexpr std::size_t text_columns   = std::to_underlying(task_field::cpu) - std::to_underlying(task_field::group);
+    static constexpr std::size_t number_columns = std::to_underlying(task_field::count) - std::to_underlying(task_field::cpu);
+
+    std::vector<task_id> ids_;
+    std::array<std::vector<std::string>, text_columns> texts_;
+    std::array<std::vector<double>, number_columns> numbers_;
+    std::vector<std::uint16_t> present_;  // one bit per task_field
+    std::vector<attributes_type> headers_; // user-defined header attributes
+    std::vector<attributes_type> bodies_;
+
+    std::vector<std::pair<attribute_key, index_type>> indexes_; // interned keys
+    bucket_type pending_;
+};
+
+
+} // namespace okec
+
+#endif // OKEC_TASK_STORE_H_
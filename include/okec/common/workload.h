@@ -0,0 +1,92 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_WORKLOAD_H_
+#define OKEC_WORKLOAD_H_
+
+#include <okec/common/task.h>
+#include <okec/common/task_source.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace okec
+{
+
+// Generates task elements in bulk from per-attribute distributions.
+//
+// The same seed always produces the same workload, including the task ids.
+// Values of well-known numeric attributes go straight into the task's typed
+// columns, nothing is formatted or parsed on the way.
+//
+//   okec::workload_generator gen(42);
+//   gen.constant("group", "dummy")
+//      .uniform("cpu", 0.2, 1.2, 2)
+//      .uniform_int("deadline", 10, 100);
+//   auto t = gen.generate(100'000);
+class workload_generator
+{
+public:
+    using engine_type       = std::mt19937_64;
+    using distribution_type = std::function<double(engine_type&)>;
+
+public:
+    explicit workload_generator(std::uint64_t seed = 0);
+
+    // Values are rounded to `precision` decimal places, unless it is negative.
+    auto uniform(std::string_view key, double low, double high, int precision = -1) -> workload_generator&;
+    auto uniform_int(std::string_view key, std::int64_t low, std::int64_t high) -> workload_generator&; // [low, high]
+    auto exponential(std::string_view key, double mean, int precision = -1) -> workload_generator&;
+    auto normal(std::string_view key, double mean, double stddev, int precision = -1) -> workload_generator&;
+    auto constant(std::string_view key, std::string_view value) -> workload_generator&;
+    auto custom(std::string_view key, distribution_type distribution, int precision = -1) -> workload_generator&;
+
+    // Appends `n` elements to `t`.
+    auto generate(task& t, std::size_t n) -> void;
+    auto generate(std::size_t n) -> task;
+
+    // A source producing `n` elements lazily. It continues from a copy of the
+    // current state, so this generator is left untouched.
+    auto source(std::size_t n) const -> std::shared_ptr<task_source>;
+
+private:
+    enum class kind : std::uint8_t { uniform, uniform_int, exponential, normal, constant, custom };
+
+    struct attribute {
+        std::string key;
+        std::optional<task_field> field;
+        kind type;
+        double a;
+        double b;
+        double scale; // 10^precision, 0 keeps full precision
+        std::string text;
+        distribution_type distribution;
+    };
+
+    auto add(std::string_view key, kind type, double a, double b, int precision) -> attribute&;
+    auto next(attribute& attr) -> double;
+    auto next_canonical() -> double;
+    auto next_bounded(std::uint64_t range) -> std::uint64_t;
+
+private:
+    engine_type engine_;
+    std::vector<attribute> attributes_;
+    bool has_id_ = false;
+};
+
+
+} // namespace okec
+
+#endif // OKEC_WORKLOAD_H_
@@ -13,6 +13,7 @@
 
 #include <okec/algorithms/decision_engine.h>
 #include <okec/common/message.h>
+#include <okec/common/task_graph.h>
 #include <okec/devices/cloud_server.h>
 #include <okec/devices/edge_device.h>
 #include <okec/utils/log.h>
@@ -67,10 +68,24 @@ public:
 
     auto write(ns3::Ptr<ns3::Packet> packet, ns3::Ipv4Address destination, uint16_t port) const -> void;
 
-    auto task_sequence(const task_element& item) -> void;
-    auto task_sequence(task_element&& item) -> void;
-    auto task_sequence() -> std::vector<task_element>&;
-    auto task_sequence_status() -> std::vector<char>&;
+    // 待分发与已分发的任务，按 task_id 查找
+    auto tasks() noexcept -> task_queue&;
+
+    // 按依赖关系放入任务队列：前驱任务全部完成后，任务才会进入就绪队列
+    // 前驱任务已失败时，任务无法执行，原样返回
+    auto submit_task(task_element item) -> std::optional<task_element>;
+
+    // 标记任务已完成，返回因此进入就绪队列的后继任务数量
+    auto complete_task(const task_id& id) -> std::size_t;
+
+    // 标记任务失败，返回因此无法执行的后继任务（包括间接后继）
+    auto fail_task(const task_id& id) -> std::vector<task_element>;
+
+    // 标记所有仍在等待前驱任务的任务失败，并返回它们
+    auto fail_waiting_tasks() -> std::vector<task_element>;
+
+    // 尚在等待前驱任务的任务数量
+    auto waiting_tasks() const -> std::size_t;
 
     auto print_task_info() -> void;
 
@@ -81,8 +96,8 @@ public:
     edge_device_container* m_edge_devices;
     ns3::Ptr<udp_application> m_udp_application;
     ns3::Ptr<ns3::Node> m_node;
-    std::vector<task_element> m_task_sequence;
-    std::vector<char> m_task_sequence_status; // 0: 未分发；1：已分发
+    task_queue m_tasks;
+    dependency_tracker m_dependencies;
     std::shared_ptr<decision_engine> m_decision_engine;
 };
 
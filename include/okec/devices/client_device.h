@@ -12,12 +12,16 @@
 #define OKEC_CLIENT_DEVICE_H_
 
 #include <okec/algorithms/decision_engine.h>
+#include <okec/common/arrival_process.h>
 #include <okec/common/message.h>
 #include <okec/common/resource.h>
 #include <okec/common/task.h>
+#include <okec/common/task_source.h>
 #include <okec/utils/format_helper.hpp>
 #include <coroutine>
+#include <deque>
 #include <functional>
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -59,6 +63,16 @@ public:
     // 发送时间如果是0s，因为UdpApplication的StartTime也是0s，所以m_socket可能尚未初始化，此时Write将无法发送
     auto send(task t) -> void;
 
+    // 从任务源中按块读取任务，在上一块的任务全部发出后再读取下一块
+    auto send(std::shared_ptr<task_source> source, std::size_t chunk_size = 256) -> void;
+
+    // 任务的到达过程，决定每个任务的发出时间。未设置时由决策引擎安装默认的周期性到达过程
+    auto set_arrival_process(std::shared_ptr<arrival_process> process) -> void;
+    auto get_arrival_process() const -> std::shared_ptr<arrival_process>;
+
+    // 按到达过程安排任务 item 的发出，到达时执行 launch
+    auto schedule_launch(const task_element& item, std::function<void()> launch) -> void;
+
     auto async_send(task t) -> std::suspend_never;
 
     auto async_read() -> response_awaiter;
@@ -76,21 +90,37 @@ public:
 
     auto dispatch(std::string_view msg_type, ns3::Ptr<ns3::Packet> packet, const ns3::Address& address) -> void;
 
-    auto response_cache() -> response_type&;
+    // 已发出任务的响应记录，整组完成后交给 when_done
+    auto response_cache() -> response_tracker&;
 
     auto has_done_callback() -> bool;
     auto done_callback(response_type res) -> void;
 
     auto write(ns3::Ptr<ns3::Packet> packet, ns3::Ipv4Address destination, uint16_t port) const -> void;
 
+private:
+    auto arm_launch_event() -> void;
+    auto run_launches() -> void;
+    auto release_held() -> void;
+    auto on_task_completed() -> void;
+    auto read_next_chunk() -> void;
 
 private:
     simulator& sim_;
     ns3::Ptr<ns3::Node> m_node;
     ns3::Ptr<udp_application> m_udp_application;
-    response_type m_response;
+    response_tracker m_response;
     done_callback_t m_done_fn;
     std::shared_ptr<decision_engine> m_decision_engine;
+
+    std::shared_ptr<arrival_process> m_arrival_process;
+    std::multimap<double, std::function<void()>> m_launches; // 按发出时间排序
+    std::deque<std::pair<task_element, std::function<void()>>> m_held; // 等待已发任务完成
+    ns3::EventId m_launch_event;
+    double m_launch_event_time = -1.0;
+
+    std::shared_ptr<task_source> m_source;
+    std::size_t m_chunk_size = 0;
 };
 
 
@@ -0,0 +1,75 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_FRAGMENT_HEADER_H_
+#define OKEC_FRAGMENT_HEADER_H_
+
+#include <ns3/header.h>
+#include <ns3/packet.h>
+#include <cstdint>
+#include <optional>
+
+
+namespace okec
+{
+
+// Header in front of each fragment of a message that does not fit in one
+// datagram. udp_application splits and reassembles such messages; messages
+// that fit are sent as they are, without this header.
+//
+// Layout (network byte order, 16 bytes):
+//   magic "OF" (2) | version (1) | reserved (1) | message sequence (4)
+//   fragment index (2) | fragment count (2) | message size (4)
+class fragment_header : public ns3::Header
+{
+public:
+    static constexpr std::uint16_t magic = 0x4F46;
+    static constexpr std::uint8_t version = 1;
+    static constexpr std::uint32_t size = 16;
+
+public:
+    static auto GetTypeId() -> ns3::TypeId;
+    auto GetInstanceTypeId() const -> ns3::TypeId override;
+
+    auto GetSerializedSize() const -> uint32_t override;
+    auto Serialize(ns3::Buffer::Iterator start) const -> void override;
+    auto Deserialize(ns3::Buffer::Iterator start) -> uint32_t override;
+    auto Print(std::ostream& os) const -> void override;
+
+    auto sequence() const noexcept -> std::uint32_t;
+    auto sequence(std::uint32_t seq) noexcept -> void;
+
+    auto index() const noexcept -> std::uint16_t;
+    auto index(std::uint16_t i) noexcept -> void;
+
+    auto count() const noexcept -> std::uint16_t;
+    auto count(std::uint16_t n) noexcept -> void;
+
+    // Size of the whole message, without fragment headers.
+    auto message_size() const noexcept -> std::uint32_t;
+    auto message_size(std::uint32_t n) noexcept -> void;
+
+    auto valid() const noexcept -> bool;
+
+    // The fragment header of `packet`, if it starts with one.
+    static auto peek(ns3::Ptr<ns3::Packet> packet) -> std::optional<fragment_header>;
+
+private:
+    bool valid_ = true;
+    std::uint32_t sequence_ = 0;
+    std::uint16_t index_ = 0;
+    std::uint16_t count_ = 1;
+    std::uint32_t message_size_ = 0;
+};
+
+
+} // namespace okec
+
+#endif // OKEC_FRAGMENT_HEADER_H_
@@ -0,0 +1,82 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_MESSAGE_HEADER_H_
+#define OKEC_MESSAGE_HEADER_H_
+
+#include <okec/common/message_type.h>
+#include <okec/common/task_id.h>
+#include <okec/utils/packet_helper.h>
+#include <ns3/header.h>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+
+namespace okec
+{
+
+// Fixed-size header in front of every message packet. It lets receivers
+// route a packet without decoding its body, and trace tools identify OKEC
+// traffic.
+//
+// Layout (network byte order, 32 bytes):
+//   magic "OK" (2) | version (1) | encoding (1) | message type (2) | reserved (2)
+//   task id (16) | group id (8)
+class message_header : public ns3::Header
+{
+public:
+    static constexpr std::uint16_t magic = 0x4F4B;
+    static constexpr std::uint8_t version = 1;
+    static constexpr std::uint32_t size = packet_helper::message_header_size;
+
+public:
+    static auto GetTypeId() -> ns3::TypeId;
+    auto GetInstanceTypeId() const -> ns3::TypeId override;
+
+    auto GetSerializedSize() const -> uint32_t override;
+    auto Serialize(ns3::Buffer::Iterator start) const -> void override;
+    auto Deserialize(ns3::Buffer::Iterator start) -> uint32_t override;
+    auto Print(std::ostream& os) const -> void override;
+
+    // message_kind::user for user-defined types.
+    auto type() const noexcept -> message_kind;
+    auto type(message_kind kind) noexcept -> void;
+
+    auto encoding() const noexcept -> packet_helper::encoding;
+    auto encoding(packet_helper::encoding e) noexcept -> void;
+
+    auto get_task_id() const noexcept -> task_id;
+    auto set_task_id(task_id id) noexcept -> void;
+
+    auto group_id() const noexcept -> std::uint64_t;
+    auto group_id(std::uint64_t id) noexcept -> void;
+
+    // Whether the header was read from a packet that actually carries one.
+    auto valid() const noexcept -> bool;
+
+    // The header of `packet`, if it starts with one.
+    static auto peek(ns3::Ptr<ns3::Packet> packet) -> std::optional<message_header>;
+
+    // Stable 64-bit hash of a group name (FNV-1a).
+    static auto hash_group(std::string_view group) noexcept -> std::uint64_t;
+
+private:
+    bool valid_ = true;
+    packet_helper::encoding encoding_ = packet_helper::encoding::text;
+    message_kind type_ = message_kind::user;
+    task_id task_id_;
+    std::uint64_t group_id_ = 0;
+};
+
+
+} // namespace okec
+
+#endif // OKEC_MESSAGE_HEADER_H_
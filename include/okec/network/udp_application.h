@@ -13,7 +13,11 @@
 
 #include <okec/common/message_handler.hpp>
 #include <ns3/application.h>
+#include <ns3/nstime.h>
 #include <ns3/socket.h>
+#include <map>
+#include <tuple>
+#include <vector>
 
 
 namespace okec
@@ -41,6 +45,15 @@ public:
 
     auto dispatch(std::string_view msg_type, ns3::Ptr<ns3::Packet> packet, const ns3::Address& address) -> void;
 
+    // Messages larger than this are split into fragments by write() and
+    // reassembled by the receiver. Defaults to the UDP payload of a 1500-byte MTU.
+    auto set_max_payload(uint32_t size) -> void;
+    auto get_max_payload() const -> uint32_t;
+
+    // Partially received messages are dropped after this long.
+    auto set_reassembly_timeout(ns3::Time timeout) -> void;
+    auto get_reassembly_timeout() const -> ns3::Time;
+
 private:
     auto StartApplication() -> void override;
     auto StopApplication() -> void override;
@@ -48,11 +61,32 @@ private:
     // 获取当前IPv4地址
     static auto get_socket_address(ns3::Ptr<ns3::Socket> socket) -> ns3::Ipv4Address;
 
+    auto handle_packet(ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void;
+
+    // Stores a fragment and returns the whole message once its last fragment arrives.
+    auto reassemble(ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> ns3::Ptr<ns3::Packet>;
+    auto drop_expired_fragments() -> void;
+
+private:
+    // sender address, sender port, message sequence
+    using reassembly_key = std::tuple<uint32_t, uint16_t, uint32_t>;
+
+    struct reassembly_buffer {
+        std::vector<ns3::Ptr<ns3::Packet>> fragments;
+        uint16_t received = 0;
+        ns3::Time expires;
+    };
+
 private:
     uint16_t m_port;
     ns3::Ptr<ns3::Socket> m_recv_socket;
     ns3::Ptr<ns3::Socket> m_send_socket;
     message_handler<callback_type> m_msg_handler;
+
+    uint32_t m_max_payload;
+    uint32_t m_next_sequence;
+    ns3::Time m_reassembly_timeout;
+    std::map<reassembly_key, reassembly_buffer> m_reassembly;
 };
 
 
@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_ARENA_H_
+#define OKEC_ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+
+namespace okec
+{
+
+// Per-thread monotonic arena for the json of short-lived messages.
+//
+// While a scope is alive, arena_allocator hands out memory from pooled
+// blocks, and the blocks are recycled all at once when the outermost scope
+// ends. A block that still holds live objects at that point (say, a message
+// moved into a scheduled event) is kept until they are freed, so escaping a
+// scope is safe, only not free. Outside any scope the allocator falls back
+// to the heap.
+class message_arena
+{
+public:
+    class scope
+    {
+    public:
+        scope() noexcept;
+        ~scope();
+
+        scope(const scope&) = delete;
+        scope& operator=(const scope&) = delete;
+    };
+
+    static auto allocate(std::size_t size, std::size_t alignment) -> void*;
+    static auto deallocate(void* p) noexcept -> void;
+
+    // Whether the calling thread is inside a scope.
+    static auto active() noexcept -> bool;
+};
+
+template <typename T>
+class arena_allocator
+{
+public:
+    using value_type = T;
+
+    arena_allocator() noexcept = default;
+
+    template <typename U>
+    arena_allocator(const arena_allocator<U>&) noexcept {}
+
+    auto allocate(std::size_t n) -> T* {
+        return static_cast<T*>(message_arena::allocate(n * sizeof(T), alignof(T)));
+    }
+
+    auto deallocate(T* p, std::size_t) noexcept -> void {
+        message_arena::deallocate(p);
+    }
+
+    template <typename U>
+    auto operator==(const arena_allocator<U>&) const noexcept -> bool { return true; }
+};
+
+// json with flat, insertion-ordered objects whose nodes come from the message
+// arena. Short keys and values stay inside std::string's small buffer.
+using arena_json = nlohmann::basic_json<nlohmann::ordered_map, std::vector, std::string, bool,
+    std::int64_t, std::uint64_t, double, arena_allocator>;
+
+
+} // namespace okec
+
+#endif // OKEC_ARENA_H_
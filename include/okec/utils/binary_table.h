@@ -0,0 +1,157 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_BINARY_TABLE_H_
+#define OKEC_BINARY_TABLE_H_
+
+#include <okec/common/task_id.h>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+namespace okec
+{
+
+// Versioned binary file holding a table of rows and named, typed columns.
+//
+// Layout (little-endian, every section 8-byte aligned):
+//   header       binary_table::header_type
+//   columns      binary_table::column_type[column_count]
+//   column data  per column a presence bitmap (one bit per row, in 64-bit
+//                words) followed by double[rows], uint32_t[rows] string
+//                offsets or uint64_t[2 * rows] ids, depending on the kind
+//   strings      NUL-terminated strings addressed by their offset
+//
+// Files are memory-mapped when loaded, values are read in place.
+class binary_table
+{
+public:
+    static constexpr char magic[4] = { 'O', 'K', 'E', 'C' };
+    static constexpr std::uint16_t version = 1;
+
+    enum class content_kind : std::uint16_t { task = 1, resource = 2 };
+    enum class column_kind : std::uint8_t { number = 0, text = 1, id = 2 };
+
+    struct header_type {
+        char magic[4];
+        std::uint16_t version;
+        std::uint16_t kind;
+        std::uint32_t column_count;
+        std::uint32_t reserved;
+        std::uint64_t row_count;
+        std::uint64_t strings_offset;
+        std::uint64_t strings_size;
+    };
+
+    struct column_type {
+        std::uint32_t name;    // offset in the string table
+        std::uint8_t kind;
+        std::uint8_t section;  // e.g. task header or body
+        std::uint16_t reserved;
+        std::uint64_t presence_offset;
+        std::uint64_t data_offset;
+    };
+
+    static_assert(std::endian::native == std::endian::little, "binary_table assumes a little-endian host");
+
+public:
+    binary_table() = default;
+    explicit binary_table(const std::string& file_name);
+    binary_table(const binary_table&) = delete;
+    binary_table& operator=(const binary_table&) = delete;
+    binary_table(binary_table&& other) noexcept;
+    binary_table& operator=(binary_table&& other) noexcept;
+    ~binary_table();
+
+    // Checks the magic number only.
+    static auto is_binary_file(const std::string& file_name) -> bool;
+
+    auto is_open() const noexcept -> bool;
+
+    auto kind() const noexcept -> content_kind;
+    auto rows() const noexcept -> std::size_t;
+    auto columns() const noexcept -> std::size_t;
+
+    auto column_name(std::size_t column) const -> std::string_view;
+    auto get_column_kind(std::size_t column) const -> column_kind;
+    auto column_section(std::size_t column) const -> std::uint8_t;
+
+    auto has_value(std::size_t column, std::size_t row) const -> bool;
+    auto numbers(std::size_t column) const -> std::span<const double>;
+    auto text(std::size_t column, std::size_t row) const -> std::string_view;
+    auto id(std::size_t column, std::size_t row) const -> task_id;
+
+private:
+    auto validate() const -> bool;
+    auto string_at(std::uint32_t offset) const -> std::string_view;
+    auto column_at(std::size_t column) const -> const column_type&;
+    auto close() -> void;
+
+private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    std::vector<char> buffer_; // used where memory mapping is unavailable
+    bool mapped_ = false;
+};
+
+
+// Builds a binary_table file in memory.
+class binary_table_writer
+{
+public:
+    using column_kind = binary_table::column_kind;
+
+    binary_table_writer(binary_table::content_kind kind, std::size_t rows);
+
+    // Returns the column with that name, kind and section, adding it if needed.
+    auto column(std::string_view name, column_kind kind, std::uint8_t section = 0) -> std::size_t;
+
+    auto set_number(std::size_t column, std::size_t row, double value) -> void;
+    auto set_text(std::size_t column, std::size_t row, std::string_view value) -> void;
+    auto set_id(std::size_t column, std::size_t row, task_id value) -> void;
+
+    auto save(const std::string& file_name) const -> bool;
+
+private:
+    struct column_data {
+        std::uint32_t name;
+        column_kind kind;
+        std::uint8_t section;
+        std::vector<std::uint64_t> presence;
+        std::vector<double> numbers;
+        std::vector<std::uint32_t> texts;
+        std::vector<std::uint64_t> ids;
+    };
+
+    auto intern(std::string_view value) -> std::uint32_t;
+    auto mark(column_data& col, std::size_t row) -> void;
+
+private:
+    binary_table::content_kind kind_;
+    std::size_t rows_;
+    std::vector<column_data> columns_;
+    std::string strings_;
+    std::unordered_map<std::string, std::uint32_t> string_offsets_;
+};
+
+
+// Converts a json task or resource file (as written by save_to_file) to the
+// binary format. Returns false if the input is neither.
+auto convert_to_binary(const std::string& json_file, const std::string& binary_file) -> bool;
+
+
+} // namespace okec
+
+#endif // OKEC_BINARY_TABLE_H_
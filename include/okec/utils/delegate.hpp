@@ -11,16 +11,17 @@
 #ifndef OKEC_DELEGATE_H_
 #define OKEC_DELEGATE_H_
 
+#include <functional>
 #include <map>
 
 
 namespace okec::utils 
 {
 
-template <typename IdentifierType, typename CallbackType>
+template <typename IdentifierType, typename CallbackType, typename Compare = std::less<IdentifierType>>
 class delegate {
 public:
-	using value_type = std::map<IdentifierType, CallbackType>;
+	using value_type = std::map<IdentifierType, CallbackType, Compare>;
 
 
 	template<typename T>
@@ -14,6 +14,7 @@
 #include <okec/common/resource.h>
 #include <okec/common/response.h>
 #include <okec/common/task.h>
+#include <okec/utils/json_helper.hpp>
 #include <format>
 #include <iostream>
 #include <ns3/ipv4.h>
@@ -70,6 +71,22 @@ struct std::formatter<ns3::Ipv4Address> {
 };
 
 
+// formatting okec::task_id
+template <>
+struct std::formatter<okec::task_id> {
+    constexpr auto parse(format_parse_context& ctx) {
+        auto it = ctx.begin(), end = ctx.end();
+        if (it != end && *it != '}') throw std::format_error("invalid task_id format");
+        return it;
+    }
+
+    template <typename FormatContext>
+    auto format(const okec::task_id& id, FormatContext& ctx) const {
+        return std::vformat_to(ctx.out(), "{}", std::make_format_args(okec::unmove(id.to_string())));
+    }
+};
+
+
 // formatting okec::task
 template <>
 struct std::formatter<okec::task> {
@@ -89,7 +106,7 @@ struct std::formatter<okec::task> {
             info += std::vformat("[{:>{}}] ", std::make_format_args(
                 okec::unmove(index++), okec::unmove(std::to_string(t.size()).length())));
 
-            if (item.contains("/header"_json_pointer))
+            if (okec::json_helper::contains(item, "header"))
             {
                 for (auto it = item["header"].begin(); it != item["header"].end(); ++it)
                 {
@@ -98,7 +115,7 @@ struct std::formatter<okec::task> {
                 }
             }
 
-            if (item.contains("/body"_json_pointer))
+            if (okec::json_helper::contains(item, "body"))
             {
                 for (auto it = item["body"].begin(); it != item["body"].end(); ++it)
                 {
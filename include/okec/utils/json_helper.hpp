@@ -0,0 +1,49 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OKEC_JSON_HELPER_HPP_
+#define OKEC_JSON_HELPER_HPP_
+
+#include <string_view>
+
+
+namespace okec
+{
+namespace json_helper
+{
+
+// Member lookup along a path of object keys, e.g. find(j, "content", "header").
+// Unlike "/content/header"_json_pointer nothing is parsed or allocated per call.
+// Returns nullptr if a key is missing or a value on the way is not an object.
+template <typename Json, typename... Keys>
+inline auto find(const Json& j, std::string_view key, Keys... rest) -> const Json* {
+    if (!j.is_object())
+        return nullptr;
+
+    auto it = j.find(key);
+    if (it == j.end())
+        return nullptr;
+
+    if constexpr (sizeof...(rest) == 0)
+        return &*it;
+    else
+        return find(*it, rest...);
+}
+
+template <typename Json, typename... Keys>
+inline auto contains(const Json& j, std::string_view key, Keys... rest) -> bool {
+    return find(j, key, rest...) != nullptr;
+}
+
+
+} // namespace json_helper
+} // namespace okec
+
+#endif // OKEC_JSON_HELPER_HPP_
@@ -19,9 +19,8 @@ namespace okec
 {
 
 
-static inline auto get_message_type(ns3::Ptr<ns3::Packet> packet) {
+static inline auto get_message_type(const json& j) {
     std::string result{};
-    json j = packet_helper::to_json(packet);
     if (!j.is_null() && j.contains("msgtype")) {
         result = j["msgtype"].get<std::string>();
     }
@@ -29,6 +28,12 @@ static inline auto get_message_type(ns3::Ptr<ns3::Packet> packet) {
     return result;
 }
 
+static inline auto get_message_type(ns3::Ptr<ns3::Packet> packet) {
+    return packet_helper::with_json(packet, [](const json& j) {
+        return get_message_type(j);
+    });
+}
+
 
 } // namespace okec
 
@@ -11,6 +11,11 @@
 #ifndef OKEC_PACKET_HELPER_H_
 #define OKEC_PACKET_HELPER_H_
 
+#include <okec/utils/arena.h>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
 #include <string_view>
 #include <nlohmann/json.hpp>
 #include <ns3/packet.h>
@@ -24,14 +29,75 @@ class response;
 
 namespace packet_helper {
 
+// Wire format of the json packets. Receivers recognize all of them, so the
+// setting only affects what is sent. Text is the easiest to read in traces.
+enum class encoding : uint8_t {
+    text,    // NUL-terminated json text
+    msgpack,
+    cbor
+};
+
+// Size of the okec::message_header in front of message packets. Decoding
+// skips it when it is still there.
+inline constexpr std::uint32_t message_header_size = 32;
+
+auto set_encoding(encoding e) noexcept -> void;
+auto get_encoding() noexcept -> encoding;
+
 auto make_packet(std::string_view sv) -> ns3::Ptr<ns3::Packet>;
 
-// convert packet to string
+// Encodes `j` according to get_encoding().
+auto to_packet(const json& j) -> ns3::Ptr<ns3::Packet>;
+auto to_packet(const arena_json& j) -> ns3::Ptr<ns3::Packet>;
+
+// The payload of `packet`, copied into a per-thread buffer that is reused by
+// the next call on the same thread (including those made by to_json and to_string).
+auto payload_view(ns3::Ptr<ns3::Packet> packet) -> std::span<const std::uint8_t>;
+
+// convert packet to string, binary packets are converted to json text
 auto to_string(ns3::Ptr<ns3::Packet> packet) -> std::string;
 
 // 
 auto to_json(ns3::Ptr<ns3::Packet> packet) -> json;
 
+// Same as to_json, but the result is allocated from the message arena.
+auto to_arena_json(ns3::Ptr<ns3::Packet> packet) -> arena_json;
+
+
+// Decodes a received packet at most once for all of its handlers. The body
+// is decoded on first use; while an instance is alive, to_json() and
+// with_json() on the same packet reuse its json instead of parsing the
+// payload again.
+class decoded_packet
+{
+public:
+    explicit decoded_packet(ns3::Ptr<ns3::Packet> packet);
+    ~decoded_packet();
+
+    decoded_packet(const decoded_packet&) = delete;
+    decoded_packet& operator=(const decoded_packet&) = delete;
+
+    auto value() const -> const json&;
+
+    // The json of `packet` if it is being dispatched, nullptr otherwise.
+    static auto find(ns3::Ptr<ns3::Packet> packet) -> const json*;
+
+private:
+    ns3::Ptr<ns3::Packet> packet_;
+    mutable std::optional<json> value_;
+    decoded_packet* previous_;
+};
+
+// Calls f with the json of `packet` without copying it if it is already decoded.
+template <typename F>
+auto with_json(ns3::Ptr<ns3::Packet> packet, F&& f) -> decltype(auto) {
+    if (auto j = decoded_packet::find(packet))
+        return std::invoke(std::forward<F>(f), *j);
+
+    const json j = to_json(packet);
+    return std::invoke(std::forward<F>(f), j);
+}
+
 
 } // namespace packet_helper
 } // namespace okec
@@ -48,25 +48,16 @@ cloud_edge_end_default_decision_engine::cloud_edge_end_default_decision_engine(
 auto cloud_edge_end_default_decision_engine::make_decision(
     const task_element &header) -> result_t
 {
-    // 获取边缘设备数据
-    auto edge_cache = this->cache().data();
-    edge_cache.erase(std::remove_if(edge_cache.begin(), edge_cache.end(), [](const device_cache::value_type& item) {
-        return item["device_type"] == "cs";
-    }));
-    // okec::print("edge cache: {}\n", edge_cache.dump(2));
-
-    auto edge_max = *std::max_element(edge_cache.begin(), edge_cache.end(), 
-        [](const device_cache::value_type& lhs, const device_cache::value_type& rhs) {
-            return TO_DOUBLE(lhs["cpu"]) < TO_DOUBLE(rhs["cpu"]);
-        });
-    // okec::print("edge max: {}\n", TO_STR(edge_max["ip"]));
-
-    double cpu_demand = std::stod(header.get_header("cpu"));
-    double cpu_supply = TO_DOUBLE(edge_max["cpu"]);
-    double tolorable_time = std::stod(header.get_header("deadline"));
-    double task_size = std::stod(header.get_header("size"));
-    double u2b_transmission_delay = std::stod(header.get_header("transmission_delay"));
-    double arrival_time = std::stod(header.get_header("arrival_time"));
+    // 剩余算力最多的边缘设备
+    auto edge_max = this->cache().worst_fit("es");
+    // okec::print("edge max: {:ip}\n", this->cache().info(*edge_max).ip);
+
+    double cpu_demand = header.get_number(task_field::cpu);
+    double cpu_supply = edge_max ? this->cache().info(*edge_max).cpu : 0.0;
+    double tolorable_time = header.get_number(task_field::deadline);
+    double task_size = header.get_number(task_field::size);
+    double u2b_transmission_delay = header.get_number(task_field::transmission_delay);
+    double arrival_time = header.get_number(task_field::arrival_time);
     double start_time = std::stod(okec::format("{:.8f}", now::seconds())); // 保证位数一致，以防相减出现负数情况
     double wait_time = start_time - arrival_time;
     okec::print("wait time: {}s\n", wait_time);
@@ -80,9 +71,10 @@ auto cloud_edge_end_default_decision_engine::make_decision(
 
         // 能够满足时延要求
         if (total_delay < tolorable_time) {
+            const auto& device = this->cache().info(*edge_max);
             return {
-                { "ip", edge_max["ip"] },
-                { "port", edge_max["port"] },
+                { "ip", okec::format("{:ip}", device.ip) },
+                { "port", std::to_string(device.port) },
                 { "cpu_supply", std::to_string(cpu_supply) },
                 { "type", "es" },
                 { "wait_time", std::to_string(wait_time) }
@@ -91,16 +83,13 @@ auto cloud_edge_end_default_decision_engine::make_decision(
     }
 
     // Otherwise, dispatch the task to cloud.
-    auto it = this->cache().find_if([](const device_cache::value_type& item) {
-        return item["device_type"] == "cs";
-    });
-    if (it != this->cache().end()) {
-        const auto& device = *it;
+    if (const auto& clouds = this->cache().devices_of("cs"); !clouds.empty()) {
+        const auto& device = this->cache().info(clouds.front());
 
-        double cs_x = TO_DOUBLE(device["pos_x"]);
-        double cs_y = TO_DOUBLE(device["pos_y"]);
-        double cs_z = TO_DOUBLE(device["pos_z"]);
-        double cloud_cpu_supply = TO_DOUBLE(device["cpu"]);
+        double cs_x = device.position.x;
+        double cs_y = device.position.y;
+        double cs_z = device.position.z;
+        double cloud_cpu_supply = device.cpu;
         double processing_time = cpu_demand / cloud_cpu_supply;
 
         double b2c_distance = this->calculate_distance(cs_x, cs_y, cs_z);
@@ -117,8 +106,8 @@ auto cloud_edge_end_default_decision_engine::make_decision(
             log::warning("B2C distance is {}m. transmission delay is {}s.", b2c_distance, b2c_transmission_delay);
             
             return {
-                { "ip", device["ip"] },
-                { "port", device["port"] },
+                { "ip", okec::format("{:ip}", device.ip) },
+                { "port", std::to_string(device.port) },
                 { "type", "cs" },
                 { "transmission_delay",  b2c_transmission_delay },
                 { "wait_time", std::to_string(wait_time) }
@@ -140,11 +129,9 @@ auto cloud_edge_end_default_decision_engine::send(
     task_element t,
     std::shared_ptr<client_device> client) -> bool
 {
-    static double launch_delay = .0; // 0.3;
-
-    client->response_cache().emplace_back({
-        { "task_id", t.get_header("task_id") },
-        { "group", t.get_header("group") },
+    client->response_cache().expect({
+        { "task_id", t.get_header(keys::task_id) },
+        { "group", t.get_header(keys::group) },
         { "finished", "0" }, // 0: unfinished, Y: finished, N: offloading failure
         { "device_type", "" },
         { "device_address", "" },
@@ -172,15 +159,15 @@ auto cloud_edge_end_default_decision_engine::send(
     
 
     // 不管本地，全部往边缘服务器卸载
-    t.set_header("from_ip", okec::format("{:ip}", client->get_address()));
-    t.set_header("from_port", std::to_string(client->get_port()));
+    t.set_header(keys::from_ip, okec::format("{:ip}", client->get_address()));
+    t.set_header(keys::from_port, std::to_string(client->get_port()));
 
     
     auto self = shared_from_base<this_type>();
-    auto write = [self, client, channelWidth, txPowerStart, t = std::move(t)]() mutable {
+    auto write = [self, client, channelWidth, txPowerStart, t]() mutable {
         auto pos = client->get_position();
         double u2b_distance = self->calculate_distance(pos.x, pos.y, pos.z);
-        double task_size = std::stod(t.get_header("size"));
+        double task_size = t.get_number(task_field::size);
         // double transmission_delay = /*task_size / 30 + */u2b_distance / 200000 + 0.02;
         double channel_gain = 4.11 * std::pow(3 * std::pow(10, 8) / (4 * std::numbers::pi * 915 * std::pow(10, 6) * u2b_distance), 2.8) * rand_rayleigh();
         double u2b_bandwidth = 5.0;
@@ -194,7 +181,7 @@ auto cloud_edge_end_default_decision_engine::send(
         log::warning("EndDevice({:ip}) position: ({:.4f},{:.4f},{:.4f}), U2B Distance: {:.8f}m", 
             client->get_address(), pos.x, pos.y, pos.z, u2b_distance);
 
-        t.set_header("transmission_delay", std::to_string(transmission_delay));
+        t.set_number(task_field::transmission_delay, transmission_delay);
         
         message msg;
         msg.type(message_decision);
@@ -203,9 +190,8 @@ auto cloud_edge_end_default_decision_engine::send(
         
         // client->write(msg.to_packet(), bs->get_address(), bs->get_port());
     };
-    ns3::Simulator::Schedule(ns3::Seconds(launch_delay), write);
+    this->launch(client.get(), t, write, .0, 1.0);
     // launch_delay += 0.01;
-    launch_delay += 1.0;
 
     return true;
 }
@@ -227,23 +213,17 @@ auto cloud_edge_end_default_decision_engine::train(const task &t, int episode) -
 
 auto cloud_edge_end_default_decision_engine::handle_next() -> void
 {
-    auto& task_sequence = m_decision_device->task_sequence();
-    log::info("handle_next.... current task sequence size: {}", task_sequence.size());
-    // for (auto& element : task_sequence) {
-    //     log::info("{}", element.dump());
-    // }
-
-    if (auto it = std::ranges::find_if(task_sequence, [](auto const& item) {
-        return item.get_header("status") == "0";
-    }); it != std::end(task_sequence)) {
-        auto target = make_decision(*it);
+    auto& tasks = m_decision_device->tasks();
+    log::info("handle_next.... ready: {}, in flight: {}", tasks.ready(), tasks.in_flight());
+
+    this->dispatch_ready([this, &tasks](task_element& item, const result_t& target) {
         // 决策失败，无法处理任务
         if (target.is_null()) {
-            log::error("No device can handle the task({})!", it->get_header("task_id"));
+            log::error("No device can handle the task({})!", item.get_header(keys::task_id));
             message response {
                 { "msgtype", "response" },
-                { "task_id", it->get_header("task_id") },
-                { "group", it->get_header("group") },
+                { "task_id", item.get_header(keys::task_id) },
+                { "group", item.get_header(keys::group) },
                 { "device_type", "null" },
                 { "device_address", "N/A" },
                 { "processing_time", "N/A" },
@@ -251,50 +231,41 @@ auto cloud_edge_end_default_decision_engine::handle_next() -> void
                 { "wait_time", "N/A" }
             };
 
-            // it->set_header("status", "1"); // 更改任务分发状态
-
-            auto from_ip = it->get_header("from_ip");
-            auto from_port = it->get_header("from_port");
+            auto from_ip = item.get_header(keys::from_ip);
+            auto from_port = item.get_header(keys::from_port);
             m_decision_device->write(response.to_packet(), ns3::Ipv4Address(from_ip.c_str()), std::stoi(from_port));
 
             // 处理过的任务从队列中清除
-            task_sequence.erase(it);
-
-            // 如果任务列表不为空
-            // if (!task_sequence.empty()) {
-            //     // 隔上0.5s再尝试处理任务列表
-            //     auto self = shared_from_base<this_type>();
-            //     ns3::Simulator::Schedule(ns3::Seconds(0.5), [self]() {
-            //         self->handle_next();
-            //     });
-            // }
-            return;
+            tasks.erase(item.get_id());
+            return false;
         }
 
         message msg;
         msg.type(message_handling);
-        msg.content(*it);
+        msg.content(item);
 
         // 卸载到边缘
         if (target["type"] == "es") {
             // okec::print("target ip: {}\n", TO_STR(target["ip"]));
             msg.attribute("cpu_supply", TO_STR(target["cpu_supply"]));
+            this->reserve(item, target); // 立即扣除缓存中的算力
         }
 
         // 卸载到云端
         if (target["type"] == "cs") {
             log::warning("Offloading to cloud");
             // 记录传输延迟
-            double u2b_transmission_delay = std::stod(it->get_header("transmission_delay"));
+            double u2b_transmission_delay = item.get_number(task_field::transmission_delay);
             okec::print("{}\n", target.dump(4));
             double b2c_transmission_delay = target["transmission_delay"].template get<double>();
-            it->set_header("transmission_delay", std::to_string(u2b_transmission_delay + b2c_transmission_delay));
+            item.set_number(task_field::transmission_delay, u2b_transmission_delay + b2c_transmission_delay);
         }
 
-        it->set_header("wait_time", TO_STR(target["wait_time"]));
-        it->set_header("status", "1"); // 更改任务分发状态
+        item.set_header("wait_time", TO_STR(target["wait_time"]));
+        tasks.dispatch(item.get_id()); // 更改任务分发状态
         m_decision_device->write(msg.to_packet(), ns3::Ipv4Address(TO_STR(target["ip"]).c_str()), TO_INT(target["port"]));
-    }
+        return true;
+    });
 }
 
 auto cloud_edge_end_default_decision_engine::on_bs_decision_message(
@@ -304,11 +275,12 @@ auto cloud_edge_end_default_decision_engine::on_bs_decision_message(
 {
     // okec::print("Resource cache:\n{}\n", this->cache().dump(4));
 
-    // task_element 为单位
-    auto item = okec::task_element::from_msg_packet(packet);
-    item.set_header("status", "0"); // 增加处理状态信息 0: 未处理 1: 已处理
-    item.set_header("arrival_time", okec::format("{:.8f}", now::seconds())); // 增加任务到达时间
-    bs->task_sequence(std::move(item));
+    // task_element 为单位，批量发送的决策消息含有多个
+    for (auto& item : decision_elements(packet)) {
+        item.set_header(keys::status, "0"); // 增加处理状态信息 0: 未处理 1: 已处理
+        item.set_header(keys::arrival_time, okec::format("{:.8f}", now::seconds())); // 增加任务到达时间
+        bs->tasks().push(std::move(item));
+    }
 
     this->handle_next();
 }
@@ -319,27 +291,23 @@ auto cloud_edge_end_default_decision_engine::on_bs_response_message(
     const ns3::Address &remote_address) -> void
 {
     message msg(packet);
-    auto& task_sequence = bs->task_sequence();
 
-    if (auto it = std::ranges::find_if(task_sequence, [&msg](auto const& item) {
-        return item.get_header("task_id") == msg.get_value("task_id");
-    }); it != std::end(task_sequence)) {
-        msg.attribute("group", it->get_header("group"));
-        msg.attribute("transmission_delay", it->get_header("transmission_delay"));
+    // 处理过的任务从队列中清除
+    auto id = task_id::from_string(msg.get_value("task_id"));
+    if (auto it = bs->tasks().erase(id)) {
+        msg.attribute("group", it->get_header(keys::group));
+        msg.attribute("transmission_delay", it->get_header(keys::transmission_delay));
         msg.attribute("wait_time", it->get_header("wait_time"));
 
         // 记录云服务器的传输时延(都有这个字段，不用单独记录了)
-        // auto transmission_delay = it->get_header("transmission_delay");
+        // auto transmission_delay = it->get_header(keys::transmission_delay);
         // if (!transmission_delay.empty()) {
         //     msg.attribute("transmission_delay", transmission_delay);
         // }
 
-        auto from_ip = (*it).get_header("from_ip");
-        auto from_port = (*it).get_header("from_port");
+        auto from_ip = it->get_header(keys::from_ip);
+        auto from_port = it->get_header(keys::from_port);
         bs->write(msg.to_packet(), ns3::Ipv4Address(from_ip.c_str()), std::stoi(from_port));
-
-        // 处理过的任务从队列中清除
-        task_sequence.erase(it);
     }
 
     this->handle_next();
@@ -353,26 +321,16 @@ auto cloud_edge_end_default_decision_engine::on_es_handling_message(
     auto ipv4_remote = ns3::InetSocketAddress::ConvertFrom(remote_address).GetIpv4();
     message msg(packet);
     auto task_item = msg.get_task_element(); // task_element::from_msg_packet(packet);
-    auto task_id = task_item.get_header("task_id");
+    auto task_id = task_item.get_header(keys::task_id);
 
     log::info("edge server({:ip}) has received a task({}).", es->get_address(), task_id);
 
-    auto es_resource = es->get_resource();
-    auto cpu_supply = std::stod(es_resource->get_value("cpu"));
-    auto cpu_demand = std::stod(task_item.get_header("cpu"));
-    auto uncertain_cpu_supply = std::stod(msg.get_value("cpu_supply"));
+    auto cpu_supply = std::stod(es->get_resource()->get_value("cpu"));
+    auto cpu_demand = task_item.get_number(task_field::cpu);
 
-    // 存在冲突，需要重新决策
-    if (uncertain_cpu_supply != cpu_supply || cpu_supply < cpu_demand) {
-        // 需要重新分配
-        log::error("Conflict! cpu_demand: {}, cpu_supply: {}, real_supply: {}.", cpu_demand, uncertain_cpu_supply, cpu_supply);
-        this->conflict(es, task_item, ipv4_remote, es->get_port());
+    // 算力不足，需要重新决策
+    if (!this->acquire(es, task_item, ipv4_remote, es->get_port()))
         return;
-    }
-
-    // 更改CPU资源
-    es_resource->reset_value("cpu", std::to_string(cpu_supply - cpu_demand));
-    this->resource_changed(es, ipv4_remote, es->get_port());
 
     // 处理任务
     double processing_time = cpu_demand / cpu_supply; // 任务能分发过来，cpu_supply 就不可能为0
@@ -385,7 +343,7 @@ auto cloud_edge_end_default_decision_engine::on_es_handling_message(
         // 处理完成，释放内存
         auto device_resource = es->get_resource();
         auto cur_cpu = std::stod(device_resource->get_value("cpu"));
-        device_resource->reset_value("cpu", std::to_string(cur_cpu + cpu_demand));
+        device_resource->reset_value("cpu", std::to_string(round_cpu(cur_cpu + cpu_demand)));
         auto device_address = okec::format("{:ip}", es->get_address());
 
         log::info("edge server({}) restores resources: {} --> {:.2f}(demand: {})", device_address, cur_cpu, cur_cpu + cpu_demand, cpu_demand);
@@ -412,11 +370,11 @@ auto cloud_edge_end_default_decision_engine::on_cloud_handling_message(
     auto ipv4_remote = ns3::InetSocketAddress::ConvertFrom(remote_address).GetIpv4();
     message msg(packet);
     auto task_item = msg.get_task_element(); // task_element::from_msg_packet(packet);
-    auto task_id = task_item.get_header("task_id");
+    auto task_id = task_item.get_header(keys::task_id);
 
     auto cs_resource = cs->get_resource();
     auto cpu_supply = std::stod(cs_resource->get_value("cpu"));
-    auto cpu_demand = std::stod(task_item.get_header("cpu"));
+    auto cpu_demand = task_item.get_number(task_field::cpu);
 
     NS_ASSERT_MSG(cpu_supply > 0, "cloud cpu cupply is not greater than 0");
 
@@ -446,36 +404,25 @@ auto cloud_edge_end_default_decision_engine::on_clients_reponse_message(
     message msg(packet);
     log::success("{}", msg.dump());
 
-    auto it = client->response_cache().find_if([&msg](const response::value_type& item) {
-        return item["group"] == msg.get_value("group") && item["task_id"] == msg.get_value("task_id");
-    });
-    if (it != client->response_cache().end()) {
-        (*it)["device_type"] = msg.get_value("device_type");
-        (*it)["device_address"] = msg.get_value("device_address");
-        (*it)["processing_delay"] = msg.get_value("processing_time");
-        (*it)["transmission_delay"] = msg.get_value("transmission_delay");
-        (*it)["wait_time"] = msg.get_value("wait_time");
-        (*it)["finished"] = msg.get_value("device_type") != "null" ? "Y" : "N";
-
-        log::success("client({:ip}) has received a response for task(id={}).", client->get_address(), msg.get_value("task_id"));
-    }
-
-    // 检查是否存在当前任务的信息
-    auto exist = client->response_cache().find_if([&msg](const auto& item) {
-        return item["group"] == msg.get_value("group");
-    });
-    if (exist == client->response_cache().end()) {
-        log::error("Fatal error! Invalid response."); // 说明发出去的数据被修改，或是 m_response 被无意间删除了信息
+    auto id = msg.get_value("task_id");
+    auto* record = client->response_cache().find(id);
+    if (!record) {
+        log::error("Fatal error! Invalid response."); // 说明发出去的数据被修改，或是重复收到了响应
         return;
     }
 
+    (*record)["device_type"] = msg.get_value("device_type");
+    (*record)["device_address"] = msg.get_value("device_address");
+    (*record)["processing_delay"] = msg.get_value("processing_time");
+    (*record)["transmission_delay"] = msg.get_value("transmission_delay");
+    (*record)["wait_time"] = msg.get_value("wait_time");
+    (*record)["finished"] = msg.get_value("device_type") != "null" ? "Y" : "N";
+
+    log::success("client({:ip}) has received a response for task(id={}).", client->get_address(), id);
+
     // 全部完成
-    auto unfinished = client->response_cache().find_if([&msg](const auto& item) {
-        return item["group"] == msg.get_value("group") && item["finished"] == "0";
-    });
-    if (unfinished == client->response_cache().end()) {
-        client->when_done(client->response_cache().dump_with({ "group", msg.get_value("group") }));
-    }
+    if (auto result = client->response_cache().complete(id))
+        client->when_done(std::move(*result));
 }
 
 } // namespace okec
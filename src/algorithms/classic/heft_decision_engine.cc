@@ -0,0 +1,379 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/algorithms/classic/heft_decision_engine.h>
+#include <okec/common/message.h>
+#include <okec/common/simulator.h>
+#include <okec/common/task_graph.h>
+#include <okec/devices/base_station.h>
+#include <okec/devices/client_device.h>
+#include <okec/devices/edge_device.h>
+#include <okec/utils/log.h>
+#include <functional> // bind_front
+#include <limits>
+
+
+namespace okec {
+
+namespace {
+
+constexpr std::string_view rank_key { "rank" };
+constexpr std::string_view successors_key { "successors" }; // 任务内后继任务的数量
+constexpr std::string_view placed_key { "placed" };         // 已分发过，冲突后重新分发时不再计数
+
+auto rank_of(const task_element& item) -> double
+{
+    auto rank = item.get_header(std::string(rank_key));
+    return rank.empty() ? .0 : std::stod(rank);
+}
+
+} // namespace
+
+
+heft_decision_engine::heft_decision_engine(
+    client_device_container* clients,
+    base_station_container* base_stations)
+    : clients_{clients}
+    , base_stations_{base_stations}
+{
+    // 设置决策设备
+    m_decision_device = base_stations->get(0);
+
+    // 初始化资源缓存信息
+    this->initialize_device(base_stations);
+
+    // Capture decision message
+    base_stations->set_request_handler(message_decision, std::bind_front(&this_type::on_bs_decision_message, this));
+    base_stations->set_request_handler(message_response, std::bind_front(&this_type::on_bs_response_message, this));
+
+    // Capture es handling message
+    base_stations->set_es_request_handler(message_handling, std::bind_front(&this_type::on_es_handling_message, this));
+
+    // Capture clients response message
+    clients->set_request_handler(message_response, std::bind_front(&this_type::on_clients_reponse_message, this));
+}
+
+heft_decision_engine::heft_decision_engine(
+    std::vector<client_device_container>* clients_container,
+    base_station_container* base_stations)
+    : clients_container_{clients_container}
+    , base_stations_{base_stations}
+{
+    // 设置决策设备
+    m_decision_device = base_stations->get(0);
+
+    // 初始化资源缓存信息
+    this->initialize_device(base_stations);
+
+    // Capture decision message
+    base_stations->set_request_handler(message_decision, std::bind_front(&this_type::on_bs_decision_message, this));
+    base_stations->set_request_handler(message_response, std::bind_front(&this_type::on_bs_response_message, this));
+
+    // Capture es handling message
+    base_stations->set_es_request_handler(message_handling, std::bind_front(&this_type::on_es_handling_message, this));
+
+    // Capture clients response message
+    for (auto& clients : *clients_container) {
+        clients.set_request_handler(message_response, std::bind_front(&this_type::on_clients_reponse_message, this));
+    }
+}
+
+auto heft_decision_engine::make_decision(const task_element& header) -> result_t
+{
+    double cpu_demand = header.get_number(task_field::cpu);
+
+    // 前驱任务的结果不在目标设备上时，需要额外的传输时间
+    std::vector<const placement*> predecessors;
+    for (const auto& id : dependencies_of(header)) {
+        if (auto it = placements_.find(id); it != placements_.end())
+            predecessors.push_back(&it->second);
+    }
+
+    const device_info* target{};
+    double earliest_finish = std::numeric_limits<double>::max();
+    for (auto index : this->cache().devices_of("es")) {
+        const auto& edge = this->cache().info(index);
+        double cpu_supply = edge.cpu;
+        if (cpu_supply <= 0 || cpu_supply < cpu_demand)
+            continue;
+
+        double ready_time{};
+        for (const auto* pred : predecessors) {
+            if (pred->ip != edge.ip)
+                ready_time = std::max(ready_time, pred->transfer_time);
+        }
+
+        double finish_time = ready_time + cpu_demand / cpu_supply;
+        if (finish_time < earliest_finish) {
+            earliest_finish = finish_time;
+            target = &edge;
+        }
+    }
+
+    if (!target)
+        return result_t();
+
+    return {
+        { "ip", okec::format("{:ip}", target->ip) },
+        { "port", std::to_string(target->port) },
+        { "cpu_supply", std::to_string(target->cpu) },
+        { "finish_time", std::to_string(earliest_finish) }
+    };
+}
+
+auto heft_decision_engine::local_test(const task_element& header, client_device* client) -> bool
+{
+    return false;
+}
+
+auto heft_decision_engine::prepare(task& t) -> void
+{
+    task_graph graph(t);
+    if (!graph.is_acyclic())
+        return;
+
+    // 平均处理能力，用于估计任务的平均执行时间
+    double capacity{};
+    std::size_t count{};
+    for (const auto& device : this->cache().devices()) {
+        capacity += device.cpu;
+        ++count;
+    }
+    capacity = count && capacity > 0 ? capacity / count : 1.0;
+
+    const auto& store = t.store();
+    auto ranks = graph.upward_ranks(
+        [&store, capacity](std::size_t i) {
+            return store.get_number(i, task_field::cpu) / capacity;
+        },
+        [&store](std::size_t i, std::size_t) {
+            return store.contains(i, task_field::transmission_delay) ? store.get_number(i, task_field::transmission_delay) : .0;
+        });
+
+    for (std::size_t i = 0; i < t.size(); ++i) {
+        t[i].set_header(std::string(rank_key), task_store::format_number(ranks[i]));
+        t[i].set_header(std::string(successors_key), std::to_string(graph.successors(i).size()));
+    }
+}
+
+auto heft_decision_engine::send(task_element t, std::shared_ptr<client_device> client) -> bool
+{
+    auto id = t.get_header(keys::task_id);
+    client->response_cache().expect({
+        { "task_id", id },
+        { "group", t.get_header(keys::group) },
+        { "finished", "0" }, // 0: unfinished, Y: finished, N: offloading failure
+        { "device_type", "" },
+        { "device_address", "" },
+        { "time_consuming", "" },
+        { "send_time", "" },
+        { "finish_time", "" }
+    });
+
+    // 全部往边缘服务器卸载，由基站按依赖关系释放
+    t.set_header(keys::from_ip, okec::format("{:ip}", client->get_address()));
+    t.set_header(keys::from_port, std::to_string(client->get_port()));
+    auto write = [self = shared_from_base<this_type>(), client, id, t]() {
+        if (auto* record = client->response_cache().find(id))
+            (*record)["send_time"] = okec::format("{:.9f}", ns3::Simulator::Now().GetSeconds());
+
+        self->write_decision(client.get(), t);
+    };
+    this->launch(client.get(), t, write, 0.3, 0.01);
+
+    return true;
+}
+
+auto heft_decision_engine::initialize() -> void
+{
+    if (clients_) {
+        clients_->set_decision_engine(shared_from_base<this_type>());
+    }
+
+    if (clients_container_) {
+        for (auto& clients : *clients_container_) {
+            clients.set_decision_engine(shared_from_base<this_type>());
+        }
+    }
+
+    if (base_stations_) {
+        base_stations_->set_decision_engine(shared_from_base<this_type>());
+
+        // 就绪任务按 upward rank 从高到低分发
+        for (auto bs : *base_stations_)
+            bs->tasks().set_policy(queue_policy::priority, rank_of);
+    }
+}
+
+auto heft_decision_engine::handle_next() -> void
+{
+    auto& tasks = m_decision_device->tasks();
+    log::info("handle_next.... ready: {}, parked: {}, in flight: {}, waiting: {}",
+        tasks.ready(), tasks.parked(), tasks.in_flight(), m_decision_device->waiting_tasks());
+
+    // 就绪任务按优先级从高到低
+    this->dispatch_ready([this, &tasks](task_element& item, const result_t& target) {
+        // 决策失败，等待资源释放后再唤醒
+        if (target.is_null()) {
+            log::info("No device can handle the task({}) for now!", item.get_header(keys::task_id));
+            this->park(item);
+            return false;
+        }
+
+        // 决策成功，可以处理任务
+        message msg;
+        msg.type(message_handling);
+        msg.content(item);
+        msg.attribute("cpu_supply", TO_STR(target["cpu_supply"]));
+        this->reserve(item, target); // 立即扣除缓存中的算力
+        tasks.dispatch(item.get_id()); // 更改任务分发状态
+
+        // 前驱任务的位置只在其后继任务决策之前有用
+        auto ip = ns3::Ipv4Address(TO_STR(target["ip"]).c_str());
+        if (item.get_header(std::string(placed_key)).empty()) {
+            item.set_header(std::string(placed_key), "1");
+            for (const auto& id : dependencies_of(item)) {
+                if (auto it = placements_.find(id); it != placements_.end() && --it->second.pending == 0)
+                    placements_.erase(it);
+            }
+        }
+
+        if (auto successors = item.get_header(std::string(successors_key)); !successors.empty() && successors != "0") {
+            placements_.insert_or_assign(item.get_id(), placement{
+                ip,
+                item.get_number(task_field::transmission_delay),
+                std::stoul(successors)
+            });
+        }
+
+        m_decision_device->write(msg.to_packet(), ip, TO_INT(target["port"]));
+        return true;
+    });
+}
+
+auto heft_decision_engine::on_bs_decision_message(
+    base_station *bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address &remote_address) -> void
+{
+    // task_element 为单位，批量发送的决策消息含有多个
+    for (auto& item : decision_elements(packet)) {
+        item.set_header(keys::status, "0"); // 增加处理状态信息 0: 未处理 1: 已处理
+        if (auto failed = bs->submit_task(std::move(item)))
+            this->reject(*failed); // 前驱任务已失败
+    }
+
+    this->handle_next();
+}
+
+auto heft_decision_engine::on_bs_response_message(
+    base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void
+{
+    message msg(packet);
+
+    // 处理过的任务从队列中清除
+    auto id = task_id::from_string(msg.get_value("task_id"));
+    if (auto it = bs->tasks().erase(id)) {
+        msg.attribute("group", it->get_header(keys::group));
+        auto from_ip = it->get_header(keys::from_ip);
+        auto from_port = it->get_header(keys::from_port);
+        bs->write(msg.to_packet(), ns3::Ipv4Address(from_ip.c_str()), std::stoi(from_port));
+    }
+
+    // 后继任务就绪，否则检查是否还有任务在等待永远不会完成的前驱
+    if (bs->complete_task(id) > 0)
+        this->handle_next();
+    else
+        this->detect_stall();
+}
+
+auto heft_decision_engine::on_es_handling_message(
+    edge_device* es, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void
+{
+    auto ipv4_remote = ns3::InetSocketAddress::ConvertFrom(remote_address).GetIpv4();
+    message msg(packet);
+    auto task_item = msg.get_task_element();
+    auto task_id = task_item.get_header(keys::task_id);
+
+    log::info("edge server({:ip}) has received a task({}).", es->get_address(), task_id);
+
+    auto cpu_supply = std::stod(es->get_resource()->get_value("cpu"));
+    auto cpu_demand = task_item.get_number(task_field::cpu);
+
+    // 算力不足，需要重新决策
+    if (!this->acquire(es, task_item, ipv4_remote, es->get_port()))
+        return;
+
+    // 处理任务
+    double processing_time = cpu_demand / cpu_supply;
+
+    log::info("edge server({:ip}) consumes resources: {} --> {}", es->get_address(), cpu_supply, cpu_supply - cpu_demand);
+    log::info("task(id={}) demand: {}, supply: {}, processing_time: {}", task_id, cpu_demand, cpu_supply, processing_time);
+
+    auto self = shared_from_base<this_type>();
+    ns3::Simulator::Schedule(ns3::Seconds(processing_time), [self, es, ipv4_remote, task_id, processing_time, cpu_demand]() {
+        // 处理完成，释放资源
+        auto device_resource = es->get_resource();
+        auto cur_cpu = std::stod(device_resource->get_value("cpu"));
+        device_resource->reset_value("cpu", std::to_string(round_cpu(cur_cpu + cpu_demand)));
+        auto device_address = okec::format("{:ip}", es->get_address());
+
+        log::info("edge server({}) restores resources: {} --> {:.2f}(demand: {})", device_address, cur_cpu, cur_cpu + cpu_demand, cpu_demand);
+
+        self->resource_changed(es, ipv4_remote, es->get_port());
+
+        message response {
+            { "msgtype", "response" },
+            { "task_id", task_id },
+            { "device_type", "es" },
+            { "device_address", device_address },
+            { "processing_time", okec::format("{:.9f}", processing_time) }
+        };
+        es->write(response.to_packet(), ipv4_remote, es->get_port());
+    });
+}
+
+auto heft_decision_engine::on_clients_reponse_message(
+    client_device* client, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void
+{
+    message msg(packet);
+
+    auto group = msg.get_value("group");
+    auto id = msg.get_value("task_id");
+    auto* record = client->response_cache().find(id);
+    if (!record) {
+        log::error("Fatal error! Invalid response.");
+        return;
+    }
+
+    (*record)["device_type"] = msg.get_value("device_type");
+    (*record)["device_address"] = msg.get_value("device_address");
+    (*record)["time_consuming"] = msg.get_value("processing_time");
+    (*record)["finish_time"] = okec::format("{:.9f}", ns3::Simulator::Now().GetSeconds());
+    (*record)["finished"] = msg.get_value("device_type") != "null" ? "Y" : "N";
+
+    log::success("client({:ip}) has received a response for task(id={}).", client->get_address(), id);
+
+    // 全部完成
+    if (auto done = client->response_cache().complete(id)) {
+        // makespan: 从第一个子任务发出到最后一个子任务完成
+        auto& result = *done;
+        double first_send = std::numeric_limits<double>::max();
+        for (const auto& item : result) {
+            if (!TO_STR(item["send_time"]).empty())
+                first_send = std::min(first_send, TO_DOUBLE(item["send_time"]));
+        }
+        if (first_send != std::numeric_limits<double>::max())
+            log::success("group({}) makespan: {:.6f}s", group, ns3::Simulator::Now().GetSeconds() - first_send);
+
+        client->when_done(std::move(result));
+    }
+}
+
+
+} // namespace okec
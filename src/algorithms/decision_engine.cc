@@ -10,18 +10,36 @@
 
 #include <okec/algorithms/decision_engine.h>
 #include <okec/devices/base_station.h>
+#include <okec/devices/client_device.h>
 #include <okec/devices/cloud_server.h>
 #include <okec/devices/edge_device.h>
 #include <okec/utils/format_helper.hpp>
+#include <okec/utils/json_helper.hpp>
 #include <okec/utils/log.h>
 #include <algorithm>
 #include <charconv>
+#include <limits>
 #include <ranges>
+#include <utility>
 
 
 namespace okec
 {
 
+namespace {
+
+// 0 for empty or malformed values
+template <typename T = double>
+auto to_number(std::string_view value) -> T
+{
+    T result{};
+    std::from_chars(value.data(), value.data() + value.size(), result);
+    return result;
+}
+
+} // namespace
+
+
 auto device_cache::begin() -> iterator
 {
     return this->view().begin();
@@ -59,7 +77,8 @@ auto device_cache::view() -> value_type&
 
 auto device_cache::size() const -> std::size_t
 {
-    return this->data().size();
+    auto items = json_helper::find(this->cache, "device_cache", "items");
+    return items ? items->size() : 0;
 }
 
 auto device_cache::empty() const -> bool
@@ -77,6 +96,136 @@ auto device_cache::emplace_back(attributes_type values) -> void
     this->emplace_back(std::move(item));
 }
 
+auto device_cache::insert(const device_info& info, const resource& r) -> std::size_t
+{
+    auto index = this->find(info.ip, info.port);
+    if (!index) {
+        this->emplace_back({
+            { "device_type", info.type },
+            { "ip", okec::format("{:ip}", info.ip) },
+            { "port", std::to_string(info.port) },
+            { "pos_x", std::to_string(info.position.x) },
+            { "pos_y", std::to_string(info.position.y) },
+            { "pos_z", std::to_string(info.position.z) }
+        });
+        index = this->size() - 1;
+    }
+
+    this->update(*index, r);
+    return *index;
+}
+
+auto device_cache::update(std::size_t index, const resource& r, std::uint64_t version) -> bool
+{
+    auto& info = infos_[index];
+    if (version && version < info.version)
+        return false;
+
+    auto& item = this->view()[index];
+    for (auto it = r.begin(); it != r.end(); ++it) {
+        if (it.key() == "cpu" && it.value().is_string())
+            this->update(index, to_number(it.value().get_ref<const std::string&>()), version);
+        else
+            item[it.key()] = it.value();
+    }
+
+    return true;
+}
+
+auto device_cache::update(std::size_t index, double cpu, std::uint64_t version) -> bool
+{
+    auto& info = infos_[index];
+    if (version && version < info.version)
+        return false;
+
+    if (version)
+        info.version = version;
+    this->set_cpu(index, cpu - info.reserved);
+    return true;
+}
+
+auto device_cache::reserve(std::size_t index, double demand) -> void
+{
+    infos_[index].reserved += demand;
+    this->set_cpu(index, infos_[index].cpu - demand);
+}
+
+auto device_cache::release(std::size_t index, double demand) -> void
+{
+    infos_[index].reserved -= demand;
+    this->set_cpu(index, infos_[index].cpu + demand);
+}
+
+auto device_cache::set_cpu(std::size_t index, double cpu) -> void
+{
+    auto& info = infos_[index];
+    if (cpu != info.cpu) {
+        auto& capacities = by_capacity_[info.type];
+        capacities.erase({ info.cpu, index });
+        capacities.emplace(cpu, index);
+        info.cpu = cpu;
+    }
+
+    this->view()[index]["cpu"] = std::to_string(cpu);
+}
+
+auto device_cache::find(ns3::Ipv4Address ip, uint16_t port) const -> std::optional<std::size_t>
+{
+    if (auto it = by_address_.find(address_key(ip, port)); it != by_address_.end())
+        return it->second;
+
+    return std::nullopt;
+}
+
+auto device_cache::info(std::size_t index) const -> const device_info&
+{
+    return infos_[index];
+}
+
+auto device_cache::devices() const -> const std::vector<device_info>&
+{
+    return infos_;
+}
+
+auto device_cache::devices_of(std::string_view type) const -> const std::vector<std::size_t>&
+{
+    static const std::vector<std::size_t> none;
+    auto it = by_type_.find(type);
+    return it != by_type_.end() ? it->second : none;
+}
+
+auto device_cache::worst_fit(std::string_view type) const -> std::optional<std::size_t>
+{
+    auto it = by_capacity_.find(type);
+    if (it == by_capacity_.end() || it->second.empty())
+        return std::nullopt;
+
+    return it->second.rbegin()->second;
+}
+
+auto device_cache::best_fit(std::string_view type, double demand) const -> std::optional<std::size_t>
+{
+    auto it = by_capacity_.find(type);
+    if (it == by_capacity_.end())
+        return std::nullopt;
+
+    const auto& capacities = it->second;
+    auto fit = capacities.lower_bound({ demand, std::numeric_limits<std::size_t>::max() });
+    if (fit == capacities.end())
+        return std::nullopt;
+
+    // 相同 cpu 中最先缓存的设备
+    return std::prev(capacities.upper_bound({ fit->first, 0 }))->second;
+}
+
+auto device_cache::capacities(std::string_view type) const -> const capacity_index&
+{
+    static const capacity_index empty_index;
+
+    auto it = by_capacity_.find(type);
+    return it != by_capacity_.end() ? it->second : empty_index;
+}
+
 auto device_cache::find_if(unary_predicate_type pred) -> iterator
 {
     auto& items = this->view();
@@ -87,22 +236,371 @@ auto device_cache::sort(binary_predicate_type comp) -> void
 {
     auto& items = this->view();
     std::sort(items.begin(), items.end(), comp);
+    this->reindex();
+}
+
+auto device_cache::reindex() -> void
+{
+    // 预留的算力不在 json 中，按地址保留下来
+    std::unordered_map<std::uint64_t, device_info> previous;
+    for (auto& info : infos_)
+        previous.emplace(address_key(info.ip, info.port), std::move(info));
+
+    infos_.clear();
+    by_address_.clear();
+    by_type_.clear();
+    by_capacity_.clear();
+    for (std::size_t i = 0; i < this->size(); ++i) {
+        this->index_back();
+        if (auto it = previous.find(address_key(infos_[i].ip, infos_[i].port)); it != previous.end()) {
+            infos_[i].reserved = it->second.reserved;
+            infos_[i].version = it->second.version;
+        }
+    }
 }
 
 auto device_cache::emplace_back(value_type item) -> void
 {
     this->cache["device_cache"]["items"].emplace_back(std::move(item));
+    this->index_back();
+}
+
+auto device_cache::index_back() -> void
+{
+    // 解析第 infos_.size() 个设备的 json 信息
+    auto index = infos_.size();
+    const auto& item = this->view()[index];
+    auto text = [&item](const char* key) -> std::string {
+        auto it = item.find(key);
+        return it != item.end() && it->is_string() ? it->get<std::string>() : std::string{};
+    };
+    auto number = [&text](const char* key) { return to_number(text(key)); };
+
+    auto& info = infos_.emplace_back();
+    info.type = text("device_type");
+    if (auto ip = text("ip"); !ip.empty())
+        info.ip = ns3::Ipv4Address(ip.c_str());
+    info.port = static_cast<uint16_t>(number("port"));
+    info.position = ns3::Vector(number("pos_x"), number("pos_y"), number("pos_z"));
+    info.cpu = number("cpu");
+
+    by_address_[address_key(info.ip, info.port)] = index;
+    by_type_[info.type].push_back(index);
+    by_capacity_[info.type].emplace(info.cpu, index);
+}
+
+auto device_cache::address_key(ns3::Ipv4Address ip, uint16_t port) noexcept -> std::uint64_t
+{
+    return (static_cast<std::uint64_t>(ip.Get()) << 16) | port;
+}
+
+auto decision_engine::launch(client_device* client, const task_element& item, std::function<void()> fn,
+    double offset, double interval) -> void
+{
+    if (!client->get_arrival_process())
+        client->set_arrival_process(std::make_shared<periodic_arrival>(offset, interval));
+
+    client->schedule_launch(item, std::move(fn));
+}
+
+auto decision_engine::write_decision(client_device* client, const task_element& item) -> void
+{
+    const auto bs = this->get_decision_device();
+    if (m_batch_window <= 0) {
+        message msg;
+        msg.type(message_decision);
+        msg.content(item);
+        client->write(msg.to_packet(), bs->get_address(), bs->get_port());
+        return;
+    }
+
+    // 文本编码的大小是所有编码中最大的，以此估算，保证批量消息不超过上限
+    constexpr std::size_t envelope_size = packet_helper::message_header_size + 64;
+    auto item_size = item.dump().size() + 1;
+    auto& batch = m_decision_batches[client];
+    if (!batch.items.is_null() && batch.size + item_size > m_batch_size)
+        this->flush_decisions(client);
+
+    if (batch.items.is_null()) {
+        batch.size = envelope_size;
+        batch.flush_event = ns3::Simulator::Schedule(ns3::Seconds(m_batch_window),
+            [self = shared_from_this(), client]() { self->flush_decisions(client); });
+    }
+
+    batch.items.push_back(item);
+    batch.size += item_size;
+}
+
+auto decision_engine::flush_decisions(client_device* client) -> void
+{
+    auto it = m_decision_batches.find(client);
+    if (it == m_decision_batches.end() || it->second.items.is_null())
+        return;
+
+    auto& batch = it->second;
+    batch.flush_event.Cancel();
+    auto items = std::exchange(batch.items, task{});
+    batch.size = 0;
+
+    message msg;
+    msg.type(message_decision);
+    if (items.size() == 1)
+        msg.content(items.at(0));
+    else
+        msg.content(items);
+
+    const auto bs = this->get_decision_device();
+    client->write(msg.to_packet(), bs->get_address(), bs->get_port());
+}
+
+auto decision_engine::decision_elements(ns3::Ptr<ns3::Packet> packet) -> std::vector<task_element>
+{
+    return packet_helper::with_json(packet, [](const json& j) {
+        std::vector<task_element> items;
+        if (j.is_null())
+            return items;
+
+        if (json_helper::contains(j, "content", "task", "items")) {
+            const auto& elements = j["content"]["task"]["items"];
+            items.reserve(elements.size());
+            for (const auto& element : elements)
+                items.emplace_back(element);
+        } else if (json_helper::contains(j, "content", "header")) {
+            items.emplace_back(j["content"]);
+        }
+
+        return items;
+    });
+}
+
+auto decision_engine::set_decision_batching(double window, std::uint32_t max_size) -> void
+{
+    m_batch_window = window;
+    m_batch_size = max_size;
+}
+
+auto decision_engine::set_stall_timeout(double seconds) -> void
+{
+    m_stall_timeout = seconds;
+}
+
+auto decision_engine::set_batch_dispatch(bool enabled) -> void
+{
+    m_batch_dispatch = enabled;
+}
+
+auto decision_engine::batch_dispatch() const noexcept -> bool
+{
+    return m_batch_dispatch;
+}
+
+auto decision_engine::make_decisions(std::span<const task_element> items) -> std::vector<result_t>
+{
+    std::vector<result_t> results;
+    results.reserve(items.size());
+    for (const auto& item : items)
+        results.push_back(this->make_decision(item));
+
+    return results;
+}
+
+auto decision_engine::dispatch_ready(const std::function<bool(task_element&, const result_t&)>& dispatch) -> void
+{
+    auto& tasks = m_decision_device->tasks();
+    if (!m_batch_dispatch) {
+        while (auto it = tasks.front()) {
+            if (dispatch(*it, this->make_decision(*it)))
+                break;
+        }
+    } else if (auto ready = tasks.ready_items(); !ready.empty()) {
+        std::vector<task_element> items;
+        items.reserve(ready.size());
+        for (auto item : ready)
+            items.push_back(*item);
+
+        auto results = this->make_decisions(items);
+        results.resize(ready.size());
+        for (std::size_t i = 0; i < ready.size(); ++i)
+            dispatch(*ready[i], results[i]);
+    }
+
+    this->detect_stall();
+}
+
+auto decision_engine::park(const task_element& item) -> void
+{
+    m_decision_device->tasks().park(item.get_id(), item.get_number(task_field::cpu));
+}
+
+auto decision_engine::wake_tasks() -> void
+{
+    // 任务只会分配给边缘服务器，只有等待中的任务放得下时才需要重新决策
+    const auto& edges = m_device_cache.capacities("es");
+    double capacity = edges.empty() ? .0 : edges.rbegin()->first;
+
+    auto& tasks = m_decision_device->tasks();
+    if (tasks.wake(capacity) > 0 || tasks.ready() > 0)
+        m_decision_device->handle_next();
+}
+
+auto decision_engine::detect_stall() -> void
+{
+    const auto& tasks = m_decision_device->tasks();
+    auto stuck = tasks.parked() + m_decision_device->waiting_tasks();
+    if (stuck == 0 || tasks.ready() > 0 || tasks.in_flight() > 0 || m_stall_event.IsPending())
+        return;
+
+    m_stall_event = ns3::Simulator::Schedule(ns3::Seconds(m_stall_timeout),
+        [self = shared_from_this()]() { self->check_stall(); });
+}
+
+auto decision_engine::check_stall() -> void
+{
+    auto& tasks = m_decision_device->tasks();
+    auto waiting = m_decision_device->waiting_tasks();
+    if (tasks.parked() + waiting == 0 || tasks.ready() > 0 || tasks.in_flight() > 0)
+        return;
+
+    if (tasks.parked() > 0) {
+        log::error("Dispatching stalled: {} task(s) fit no device and nothing is in flight.", tasks.parked());
+        for (const auto& item : tasks.take_parked())
+            this->reject(item);
+    }
+
+    // 前驱任务从未到达（不在任务中、所在的块没有读取或位于跨块的环上）
+    if (waiting > 0) {
+        log::error("Dispatching stalled: {} task(s) wait for predecessors that never arrived.", waiting);
+        for (const auto& item : m_decision_device->fail_waiting_tasks())
+            this->reject(item);
+    }
+}
+
+auto decision_engine::reject(const task_element& item) -> void
+{
+    log::error("task({}) has failed!", item.get_header(keys::task_id));
+
+    auto respond = [this](const task_element& failed) {
+        message response {
+            { "msgtype", "response" },
+            { "task_id", failed.get_header(keys::task_id) },
+            { "group", failed.get_header(keys::group) },
+            { "device_type", "null" },
+            { "device_address", "N/A" },
+            { "processing_time", "N/A" }
+        };
+
+        auto from_ip = failed.get_header(keys::from_ip);
+        auto from_port = failed.get_header(keys::from_port);
+        m_decision_device->write(response.to_packet(), ns3::Ipv4Address(from_ip.c_str()), std::stoi(from_port));
+    };
+
+    respond(item);
+
+    // 后继任务永远等不到该任务完成
+    for (const auto& next : m_decision_device->fail_task(item.get_id())) {
+        log::error("task({}) fails with its predecessor({}).", next.get_header(keys::task_id), item.get_header(keys::task_id));
+        respond(next);
+    }
+}
+
+auto decision_engine::set_report_batching(double window) -> void
+{
+    m_report_window = window;
+}
+
+auto decision_engine::reserve(const task_element& item, const result_t& target) -> void
+{
+    auto ip = ns3::Ipv4Address(TO_STR(target["ip"]).c_str());
+    auto port = static_cast<uint16_t>(TO_INT(target["port"]));
+    auto index = m_device_cache.find(ip, port);
+    if (!index)
+        return;
+
+    auto demand = item.get_number(task_field::cpu);
+    m_device_cache.reserve(*index, demand);
+    m_reservations.insert_or_assign(item.get_id(), reservation{ ip, port, demand });
+}
+
+auto decision_engine::settle(std::string_view acks) -> void
+{
+    for (auto id : acks | std::views::split(',')) {
+        if (!id.empty())
+            this->settle(task_id::from_string(std::string_view(id.begin(), id.end())));
+    }
+}
+
+auto decision_engine::settle(const task_id& id) -> void
+{
+    auto it = m_reservations.find(id);
+    if (it == m_reservations.end())
+        return;
+
+    if (auto index = m_device_cache.find(it->second.ip, it->second.port))
+        m_device_cache.release(*index, it->second.demand);
+    m_reservations.erase(it);
+}
+
+auto decision_engine::acquire(edge_device* es, const task_element& item,
+    ns3::Ipv4Address remote_ip, uint16_t remote_port) -> bool
+{
+    auto es_resource = es->get_resource();
+    auto cpu_supply = std::stod(es_resource->get_value("cpu"));
+    auto cpu_demand = item.get_number(task_field::cpu);
+    auto& state = m_device_states[es];
+
+    // 基站已预留算力，只有算力确实不足时才需要重新决策
+    if (cpu_supply < cpu_demand) {
+        log::error("Conflict! cpu_demand: {}, real_supply: {}", cpu_demand, cpu_supply);
+        this->conflict(es, item, remote_ip, remote_port);
+        return false;
+    }
+
+    // 更改CPU资源，随下一次资源报告确认
+    es_resource->reset_value("cpu", std::to_string(round_cpu(cpu_supply - cpu_demand)));
+    state.acks.push_back(item.get_header(keys::task_id));
+    this->resource_changed(es, remote_ip, remote_port);
+    return true;
 }
 
 auto decision_engine::resource_changed(edge_device* es,
     ns3::Ipv4Address remote_ip, uint16_t remote_port) -> void
 {
+    auto& state = m_device_states[es];
+    ++state.version;
+    state.remote_ip = remote_ip;
+    state.remote_port = remote_port;
+
+    if (m_report_window <= 0) {
+        this->report_resource(es);
+        return;
+    }
+
+    if (!state.report_event.IsPending()) {
+        state.report_event = ns3::Simulator::Schedule(ns3::Seconds(m_report_window),
+            [self = shared_from_this(), es]() { self->report_resource(es); });
+    }
+}
+
+auto decision_engine::report_resource(edge_device* es) -> void
+{
+    auto& state = m_device_states[es];
+    state.report_event.Cancel();
+
+    std::string acks;
+    for (const auto& id : std::exchange(state.acks, {})) {
+        if (!acks.empty())
+            acks += ',';
+        acks += id;
+    }
+
     message notify_msg;
     notify_msg.type(message_resource_changed);
     notify_msg.attribute("ip", okec::format("{:ip}", es->get_address()));
     notify_msg.attribute("port", std::to_string(es->get_port()));
+    notify_msg.attribute("version", std::to_string(state.version));
+    notify_msg.attribute("acks", acks);
     notify_msg.content(*es->get_resource());
-    es->write(notify_msg.to_packet(), remote_ip, remote_port);
+    es->write(notify_msg.to_packet(), state.remote_ip, state.remote_port);
 }
 
 auto decision_engine::conflict(edge_device* es, const task_element& item, ns3::Ipv4Address remote_ip, uint16_t remote_port) -> void
@@ -110,6 +608,10 @@ auto decision_engine::conflict(edge_device* es, const task_element& item, ns3::I
     message conflict_msg;
     conflict_msg.type(message_conflict);
     conflict_msg.content(item);
+    conflict_msg.attribute("ip", okec::format("{:ip}", es->get_address()));
+    conflict_msg.attribute("port", std::to_string(es->get_port()));
+    conflict_msg.attribute("cpu", es->get_resource()->get_value("cpu"));
+    conflict_msg.attribute("version", std::to_string(m_device_states[es].version));
     es->write(conflict_msg.to_packet(), remote_ip, remote_port);
 }
 
@@ -145,24 +647,9 @@ auto decision_engine::initialize_device(base_station_container* bs_container, cl
         auto cs_res = cs->get_resource();
 
         if (cs_res && !cs_res->empty()) {
-            m_device_cache.emplace_back({
-                { "device_type", "cs" },
-                { "ip", okec::format("{:ip}", cs->get_address()) },
-                { "port", std::to_string(cs->get_port()) },
-                { "pos_x", std::to_string(cs_pos.x) },
-                { "pos_y", std::to_string(cs_pos.y) },
-                { "pos_z", std::to_string(cs_pos.z) }
-            });
-
-            auto find_pred = [](const device_cache::value_type& item) {
-                return item["device_type"] == "cs";
-            };
-            auto item = m_device_cache.find_if(find_pred);
-            if (item != m_device_cache.end())
-                for (auto it = cs_res->begin(); it != cs_res->end(); ++it)
-                    (*item)[it.key()] = it.value();
-
-            log::debug("The decision engine got the resource information of cloud({}).", (*item)["ip"].template get<std::string>());
+            m_device_cache.insert({ "cs", cs->get_address(), cs->get_port(), cs_pos }, *cs_res);
+
+            log::debug("The decision engine got the resource information of cloud({:ip}).", cs->get_address());
         } else {
             // 说明设备此时还未绑定资源，通过网络询问一下
             ns3::Simulator::Schedule(ns3::Seconds(1.0), +[](const std::shared_ptr<base_station> socket, const ns3::Ipv4Address& ip, uint16_t port) {
@@ -173,122 +660,8 @@ auto decision_engine::initialize_device(base_station_container* bs_container, cl
         }
     }
 
-    // 记录边缘服务器信息
-    double delay = 1.0;
-    std::for_each(bs_container->begin(), bs_container->end(),
-    [&delay, this](const base_station_container::pointer_t bs) {
-        for (const auto& device : bs->get_edge_devices()) {
-            auto p_resource = device->get_resource();
-
-            // 动态记录资源信息
-            if (p_resource && !p_resource->empty()) {
-                // 设备已经绑定资源，直接记录
-                auto es_pos = device->get_position();
-                auto ip = okec::format("{:ip}", device->get_address());
-                auto port = std::to_string(device->get_port());
-
-                m_device_cache.emplace_back({
-                    { "device_type", "es" },
-                    { "ip", ip },
-                    { "port", port },
-                    { "pos_x", std::to_string(es_pos.x) },
-                    { "pos_y", std::to_string(es_pos.y) },
-                    { "pos_z", std::to_string(es_pos.z) }
-                });
-
-                auto find_pred = [&ip, &port](const device_cache::value_type& item) {
-                    return item["ip"] == ip && item["port"] == port;
-                };
-                auto item = m_device_cache.find_if(find_pred);
-                if (item != m_device_cache.end()) {
-                    for (auto it = p_resource->begin(); it != p_resource->end(); ++it) {
-                        (*item)[it.key()] = it.value();
-                    }
-                }
-
-                log::debug("The decision engine got the resource information of edge device({}).", (*item)["ip"].template get<std::string>());
-            } else {
-                // 说明设备此时还未绑定资源，通过网络询问一下
-                ns3::Simulator::Schedule(ns3::Seconds(delay), +[](const std::shared_ptr<base_station> socket, const ns3::Ipv4Address& ip, uint16_t port) {
-                    message msg;
-                    msg.type(message_get_resource_information);
-                    socket->write(msg.to_packet(), ip, port);
-                }, this->m_decision_device, device->get_address(), device->get_port());
-                delay += 0.1;
-            }
-        }
-    });
-
-    // okec::print("Info: {}\n", m_device_cache.dump());
-
-    // 捕获通过网络问询的信息，更新设备信息（能收到就一定存在资源信息）
-    m_decision_device->set_request_handler(message_resource_information, 
-        [this](okec::base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) {
-            log::debug("The decision engine has received device resource information: {}", okec::packet_helper::to_string(packet));
-
-            auto msg = message::from_packet(packet);
-            auto es_resource = resource::from_msg_packet(packet);
-            auto ip = msg.get_value("ip");
-            auto port = msg.get_value("port");
-
-            m_device_cache.emplace_back({
-                { "device_type", msg.get_value("device_type") },
-                { "ip", ip },
-                { "port", port },
-                { "pos_x", msg.get_value("pos_x") },
-                { "pos_y", msg.get_value("pos_y") },
-                { "pos_z", msg.get_value("pos_z") }
-            });
-
-            auto find_pred = [&ip, &port](const device_cache::value_type& item) {
-                return item["ip"] == ip && item["port"] == port;
-            };
-            auto item = m_device_cache.find_if(find_pred);
-            if (item != m_device_cache.end()) {
-                for (auto it = es_resource.begin(); it != es_resource.end(); ++it) {
-                    (*item)[it.key()] = it.value();
-                }
-            }
-        });
-
-    // 捕获资源变化信息
-    // 资源更新(外部所指定的BS不一定是第0个，所以要为所有BS设置消息以确保捕获)
-    bs_container->set_request_handler(message_resource_changed, 
-        [this](okec::base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) {
-            // okec::print("At time {:.2f}s The decision engine got notified about device resource changes: {}\n", Simulator::Now().GetSeconds() , okec::packet_helper::to_string(packet));
-            auto msg = message::from_packet(packet);
-            auto es_resource = resource::from_msg_packet(packet);
-            auto ip = msg.get_value("ip");
-            auto port = msg.get_value("port");
-
-            // 更新资源信息
-            auto find_pred = [&ip, &port](const device_cache::value_type& item) {
-                return item["ip"] == ip && item["port"] == port;
-            };
-            auto item = m_device_cache.find_if(find_pred);
-            if (item != m_device_cache.end()) {
-                for (auto it = es_resource.begin(); it != es_resource.end(); ++it) {
-                    (*item)[it.key()] = it.value();
-                }
-            }
-
-            // 继续处理下一个任务的分发
-            bs->handle_next();
-        });
-
-    // 捕获资源冲突问题
-    bs_container->set_request_handler(message_conflict,
-        [this](okec::base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) {
-            auto task_item = task_element::from_msg_packet(packet);
-            auto& task_sequence = bs->task_sequence();
-            if (auto it = std::ranges::find_if(task_sequence, [&task_item](auto const& item) {
-                return item.get_header("task_id") == task_item.get_header("task_id");
-            }); it != std::end(task_sequence)) {
-                // okec::print("找到了 {} status: {}\n", (*it).get_header("task_id"), (*it).get_header("status"));
-                (*it).set_header("status", "0");
-                bs->handle_next(); // 重新处理
-            }
-        });
+    this->cache_edge_devices(bs_container);
+    this->register_handlers(bs_container);
 }
 
 auto decision_engine::initialize_device(base_station_container* bs_container) -> void
@@ -297,6 +670,12 @@ auto decision_engine::initialize_device(base_station_container* bs_container) ->
     if (!m_decision_device)
         m_decision_device = bs_container->get(0);
 
+    this->cache_edge_devices(bs_container);
+    this->register_handlers(bs_container);
+}
+
+auto decision_engine::cache_edge_devices(base_station_container* bs_container) -> void
+{
     // 记录边缘服务器信息
     double delay = 1.0;
     std::for_each(bs_container->begin(), bs_container->end(),
@@ -307,30 +686,9 @@ auto decision_engine::initialize_device(base_station_container* bs_container) ->
             // 动态记录资源信息
             if (p_resource && !p_resource->empty()) {
                 // 设备已经绑定资源，直接记录
-                auto es_pos = device->get_position();
-                auto ip = okec::format("{:ip}", device->get_address());
-                auto port = std::to_string(device->get_port());
-
-                m_device_cache.emplace_back({
-                    { "device_type", "es" },
-                    { "ip", ip },
-                    { "port", port },
-                    { "pos_x", std::to_string(es_pos.x) },
-                    { "pos_y", std::to_string(es_pos.y) },
-                    { "pos_z", std::to_string(es_pos.z) }
-                });
-
-                auto find_pred = [&ip, &port](const device_cache::value_type& item) {
-                    return item["ip"] == ip && item["port"] == port;
-                };
-                auto item = m_device_cache.find_if(find_pred);
-                if (item != m_device_cache.end()) {
-                    for (auto it = p_resource->begin(); it != p_resource->end(); ++it) {
-                        (*item)[it.key()] = it.value();
-                    }
-                }
-
-                log::debug("The decision engine received resource information from edge server({}).", (*item)["ip"].template get<std::string>());
+                m_device_cache.insert({ "es", device->get_address(), device->get_port(), device->get_position() }, *p_resource);
+
+                log::debug("The decision engine got the resource information of edge device({:ip}).", device->get_address());
             } else {
                 // 说明设备此时还未绑定资源，通过网络询问一下
                 ns3::Simulator::Schedule(ns3::Seconds(delay), +[](const std::shared_ptr<base_station> socket, const ns3::Ipv4Address& ip, uint16_t port) {
@@ -342,37 +700,24 @@ auto decision_engine::initialize_device(base_station_container* bs_container) ->
             }
         }
     });
+}
 
-    // okec::print("Info: {}\n", m_device_cache.dump());
-
+auto decision_engine::register_handlers(base_station_container* bs_container) -> void
+{
     // 捕获通过网络问询的信息，更新设备信息（能收到就一定存在资源信息）
     m_decision_device->set_request_handler(message_resource_information, 
         [this](okec::base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) {
             log::debug("The decision engine has received device resource information: {}", okec::packet_helper::to_string(packet));
-            
+
             auto msg = message::from_packet(packet);
             auto es_resource = resource::from_msg_packet(packet);
             auto ip = msg.get_value("ip");
-            auto port = msg.get_value("port");
-
-            m_device_cache.emplace_back({
-                { "device_type", msg.get_value("device_type") },
-                { "ip", ip },
-                { "port", port },
-                { "pos_x", msg.get_value("pos_x") },
-                { "pos_y", msg.get_value("pos_y") },
-                { "pos_z", msg.get_value("pos_z") }
-            });
-
-            auto find_pred = [&ip, &port](const device_cache::value_type& item) {
-                return item["ip"] == ip && item["port"] == port;
-            };
-            auto item = m_device_cache.find_if(find_pred);
-            if (item != m_device_cache.end()) {
-                for (auto it = es_resource.begin(); it != es_resource.end(); ++it) {
-                    (*item)[it.key()] = it.value();
-                }
-            }
+            auto address = ip.empty() ? ns3::InetSocketAddress::ConvertFrom(remote_address).GetIpv4() : ns3::Ipv4Address(ip.c_str());
+            auto position = ns3::Vector(to_number(msg.get_value("pos_x")), to_number(msg.get_value("pos_y")), to_number(msg.get_value("pos_z")));
+
+            m_device_cache.insert({ msg.get_value("device_type"), address,
+                static_cast<uint16_t>(to_number(msg.get_value("port"))), position }, es_resource);
+            this->wake_tasks();
         });
 
     // 捕获资源变化信息
@@ -383,35 +728,33 @@ auto decision_engine::initialize_device(base_station_container* bs_container) ->
             auto msg = message::from_packet(packet);
             auto es_resource = resource::from_msg_packet(packet);
             auto ip = msg.get_value("ip");
-            auto port = msg.get_value("port");
-
-            // 更新资源信息
-            auto find_pred = [&ip, &port](const device_cache::value_type& item) {
-                return item["ip"] == ip && item["port"] == port;
-            };
-            auto item = m_device_cache.find_if(find_pred);
-            if (item != m_device_cache.end()) {
-                for (auto it = es_resource.begin(); it != es_resource.end(); ++it) {
-                    (*item)[it.key()] = it.value();
-                }
+            auto port = static_cast<uint16_t>(to_number(msg.get_value("port")));
+
+            // 更新资源信息，已确认任务的预留算力已包含在报告中
+            if (auto index = m_device_cache.find(ns3::Ipv4Address(ip.c_str()), port)) {
+                this->settle(msg.get_value("acks"));
+                m_device_cache.update(*index, es_resource, to_number<std::uint64_t>(msg.get_value("version")));
             }
 
             // 继续处理下一个任务的分发
-            bs->handle_next();
+            this->wake_tasks();
         });
 
     // 捕获资源冲突问题
     bs_container->set_request_handler(message_conflict,
         [this](okec::base_station* bs, ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) {
-            auto task_item = task_element::from_msg_packet(packet);
-            auto& task_sequence = bs->task_sequence();
-            if (auto it = std::ranges::find_if(task_sequence, [&task_item](auto const& item) {
-                return item.get_header("task_id") == task_item.get_header("task_id");
-            }); it != std::end(task_sequence)) {
-                // okec::print("找到了 {} status: {}\n", (*it).get_header("task_id"), (*it).get_header("status"));
-                (*it).set_header("status", "0");
-                bs->handle_next(); // 重新处理
-            }
+            auto msg = message::from_packet(packet);
+            auto task_item = msg.get_task_element();
+            auto ip = msg.get_value("ip");
+            auto port = static_cast<uint16_t>(to_number(msg.get_value("port")));
+
+            // 释放预留的算力，并以边缘服务器的当前算力校正缓存
+            this->settle(task_item.get_id());
+            if (auto index = m_device_cache.find(ns3::Ipv4Address(ip.c_str()), port))
+                m_device_cache.update(*index, to_number(msg.get_value("cpu")), to_number<std::uint64_t>(msg.get_value("version")));
+
+            if (m_decision_device->tasks().requeue(task_item.get_id()))
+                m_decision_device->handle_next(); // 重新处理
         });
 }
 
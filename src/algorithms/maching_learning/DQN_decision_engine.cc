@@ -29,7 +29,7 @@ Env::Env(const device_cache& cache, const task& t, std::shared_ptr<DeepQNetwork>
 {
     // 先为所有任务设置处理标识
     for (auto& t : t_.elements_view()) {
-        t.set_header("status", "0"); // 0: 未处理 1: 已处理
+        t.set_header(keys::status, "0"); // 0: 未处理 1: 已处理
     }
 
     // observation_ = next_observation();
@@ -45,17 +45,14 @@ auto Env::reset() -> torch::Tensor
 
 auto Env::next_observation() -> torch::Tensor
 {
-    auto task_elements = this->t_.elements_view();
-    if (auto it = std::ranges::find_if(task_elements, [](auto const& item) {
-        return item.get_header("status") == "0";
-    }); it != std::end(task_elements)) {
+    if (auto item = this->t_.next_pending(); !item.empty()) {
         auto& edge_cache = this->cache_.view();
         std::vector<double> flattened_state;
         for (const auto& edge : edge_cache) {
             flattened_state.push_back(TO_DOUBLE(edge["cpu"]));
         }
 
-        flattened_state.push_back(std::stod((it)->get_header("cpu")));
+        flattened_state.push_back(item.get_number(task_field::cpu));
         return torch::tensor(flattened_state, torch::dtype(torch::kFloat64)).unsqueeze(0);
     }
 
@@ -77,10 +74,7 @@ auto Env::train_next(torch::Tensor observation) -> void
     // okec::print("train task:\n {}\n", t_.dump(4));
 
     float reward;
-    auto task_elements = t_.elements_view();
-    if (auto it = std::ranges::find_if(task_elements, [](auto const& item) {
-        return item.get_header("status") == "0";
-    }); it != std::end(task_elements)) {
+    if (auto item = t_.next_pending(); !item.empty()) {
         auto& edge_cache = cache_.view();
         auto action = RL_->choose_action(observation);
         auto& server = edge_cache.at(action);
@@ -92,7 +86,7 @@ auto Env::train_next(torch::Tensor observation) -> void
         float beta = 0.2; // 9/1 出现过23 8/2 也是
 
         auto cpu_supply = TO_DOUBLE(server["cpu"]);
-        auto cpu_demand = std::stod(it->get_header("cpu"));
+        auto cpu_demand = item.get_number(task_field::cpu);
 
         // 计算平均处理时间
         std::vector<double> time;
@@ -104,7 +98,7 @@ auto Env::train_next(torch::Tensor observation) -> void
         double average_processing_time = std::accumulate(time.begin(), time.end(), .0) / time.size();
         double processing_time;
 
-        // okec::print("正在处理 {}, supply: {}, demand: {}\n", it->get_header("task_id"), cpu_supply, cpu_demand);
+        // okec::print("正在处理 {}, supply: {}, demand: {}\n", item.get_header(keys::task_id), cpu_supply, cpu_demand);
 
         if (cpu_supply < cpu_demand) { // 无法处理
             processing_time = cpu_demand / cpu_supply;
@@ -119,8 +113,8 @@ auto Env::train_next(torch::Tensor observation) -> void
         } else { // 可以处理
             processing_time = cpu_demand / cpu_supply;
             double new_cpu = cpu_supply - cpu_demand;
-            it->set_header("status", "1");
-            it->set_header("processing_time", std::to_string(processing_time));
+            item.set_header(keys::status, "1");
+            item.set_header("processing_time", std::to_string(processing_time));
 
             // 消耗资源
             server["cpu"] = std::to_string(new_cpu);
@@ -308,11 +302,9 @@ auto DQN_decision_engine::local_test(const task_element& header, client_device*
 
 auto DQN_decision_engine::send(task_element t, std::shared_ptr<client_device> client) -> bool
 {
-    static double launch_delay = 1.0;
-
-    client->response_cache().emplace_back({
-        { "task_id", t.get_header("task_id") },
-        { "group", t.get_header("group") },
+    client->response_cache().expect({
+        { "task_id", t.get_header(keys::task_id) },
+        { "group", t.get_header(keys::group) },
         { "finished", "0" }, // 1 indicates finished, while 0 signifies the opposite.
         { "device_type", "" },
         { "device_address", "" },
@@ -323,18 +315,13 @@ auto DQN_decision_engine::send(task_element t, std::shared_ptr<client_device> cl
 
     // 将所有任务都发送到决策设备，从而得到所有任务的信息
     // 追加任务发送地址信息
-    t.set_header("from_ip", okec::format("{:ip}", client->get_address()));
-    t.set_header("from_port", std::to_string(client->get_port()));
-    message msg;
-    msg.type(message_decision);
-    msg.content(t);
-    const auto bs = this->get_decision_device();
-    auto write = [client, bs, content = msg.to_packet()]() {
-        client->write(content, bs->get_address(), bs->get_port());
+    t.set_header(keys::from_ip, okec::format("{:ip}", client->get_address()));
+    t.set_header(keys::from_port, std::to_string(client->get_port()));
+    auto write = [self = shared_from_base<this_type>(), client, t]() {
+        self->write_decision(client.get(), t);
     };
-    ns3::Simulator::Schedule(ns3::Seconds(launch_delay), write);
+    this->launch(client.get(), t, write, 1.0, 0.1);
     // ns3::Simulator::Schedule(ns3::Seconds(launch_delay), &client_device::write, client, msg.to_packet(), bs->get_address(), bs->get_port());
-    launch_delay += 0.1;
 
     return true;
 }
@@ -363,7 +350,7 @@ auto DQN_decision_engine::train(const task& train_task, int episode) -> void
     // auto observation = torch::tensor(state, torch::dtype(torch::kFloat64)).unsqueeze(0);
 
     // for (auto& t : train_task.elements()) {
-    //     t.set_header("status", "0"); // 0: 未处理 1: 已处理
+    //     t.set_header(keys::status, "0"); // 0: 未处理 1: 已处理
     // }
 
     // train_next(std::move(observation));
@@ -451,8 +438,8 @@ auto DQN_decision_engine::on_bs_decision_message(
     ns3::InetSocketAddress inetRemoteAddress = ns3::InetSocketAddress::ConvertFrom(remote_address);
     log::debug("The base station[{:ip}] has received the decision request from {:ip}.", bs->get_address(), inetRemoteAddress.GetIpv4());
 
-    auto item = okec::task_element::from_msg_packet(packet);
-    bs->task_sequence(std::move(item));
+    for (auto& item : decision_elements(packet))
+        bs->tasks().push(std::move(item));
 
     // bs->print_task_info();
     // bs->handle_next_task();
@@ -0,0 +1,182 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/common/arrival_process.h>
+#include <algorithm>
+#include <cmath>
+#include <ranges>
+#include <stdexcept>
+
+
+namespace okec
+{
+
+namespace {
+
+// 53 random bits in [0, 1)
+auto canonical(std::mt19937_64& engine) -> double
+{
+    return static_cast<double>(engine() >> 11) * 0x1.0p-53;
+}
+
+auto exponential_gap(std::mt19937_64& engine, double rate) -> double
+{
+    return -std::log1p(-canonical(engine)) / rate;
+}
+
+} // namespace
+
+
+periodic_arrival::periodic_arrival(double offset, double interval)
+    : offset_{ offset }
+    , interval_{ interval }
+{
+}
+
+auto periodic_arrival::next(const task_element&, double now) -> std::optional<double>
+{
+    if (last_ < 0 || last_ + interval_ < now)
+        last_ = now + offset_;
+    else
+        last_ += interval_;
+
+    return last_;
+}
+
+auto periodic_arrival::reset() -> void
+{
+    last_ = -1.0;
+}
+
+poisson_arrival::poisson_arrival(double rate, std::uint64_t seed, double start)
+    : rate_{ rate }
+    , seed_{ seed }
+    , start_{ start }
+    , engine_{ seed }
+{
+}
+
+auto poisson_arrival::next(const task_element&, double now) -> std::optional<double>
+{
+    // Absolute times, so the offered load does not drift with the clock.
+    if (last_ < 0)
+        last_ = std::max(start_, now);
+
+    last_ += exponential_gap(engine_, rate_);
+    return last_;
+}
+
+auto poisson_arrival::reset() -> void
+{
+    engine_.seed(seed_);
+    last_ = -1.0;
+}
+
+mmpp_arrival::mmpp_arrival(std::vector<double> rates, std::vector<double> sojourn, std::uint64_t seed, double start)
+    : rates_{ std::move(rates) }
+    , sojourn_{ std::move(sojourn) }
+    , seed_{ seed }
+    , start_{ start }
+    , engine_{ seed }
+{
+    sojourn_.resize(rates_.size(), 1.0);
+
+    // 否则 next() 永远找不到下一个到达时间
+    auto emits = [this](std::size_t i) { return rates_[i] > 0 && sojourn_[i] > 0; };
+    if (std::ranges::none_of(std::views::iota(std::size_t{}, rates_.size()), emits))
+        throw std::invalid_argument{"mmpp_arrival: no state with both a positive rate and a positive sojourn"};
+}
+
+auto mmpp_arrival::next(const task_element&, double now) -> std::optional<double>
+{
+    if (last_ < 0) {
+        last_ = std::max(start_, now);
+        state_ = 0;
+        state_end_ = last_ + exponential(sojourn_[state_]);
+    }
+
+    // Memorylessness lets us restart the gap whenever the state changes.
+    for (;;) {
+        auto candidate = rates_[state_] > 0 ? last_ + exponential_gap(engine_, rates_[state_]) : state_end_;
+        if (candidate < state_end_) {
+            last_ = candidate;
+            return last_;
+        }
+
+        last_ = state_end_;
+        state_ = (state_ + 1) % rates_.size();
+        state_end_ = last_ + exponential(sojourn_[state_]);
+    }
+}
+
+auto mmpp_arrival::reset() -> void
+{
+    engine_.seed(seed_);
+    state_ = 0;
+    state_end_ = -1.0;
+    last_ = -1.0;
+}
+
+auto mmpp_arrival::exponential(double mean) -> double
+{
+    return mean > 0 ? exponential_gap(engine_, 1.0 / mean) : .0;
+}
+
+trace_arrival::trace_arrival(std::vector<double> timestamps)
+    : timestamps_{ std::move(timestamps) }
+{
+}
+
+auto trace_arrival::next(const task_element& item, double now) -> std::optional<double>
+{
+    double at = now;
+    if (timestamps_.empty())
+        at = item.get_number(task_field::arrival_time);
+    else if (position_ < timestamps_.size())
+        at = timestamps_[position_++];
+
+    return std::max(at, now);
+}
+
+auto trace_arrival::reset() -> void
+{
+    position_ = 0;
+}
+
+closed_loop_arrival::closed_loop_arrival(std::size_t concurrency, double think_time, double offset)
+    : concurrency_{ std::max<std::size_t>(concurrency, 1) }
+    , think_time_{ think_time }
+    , offset_{ offset }
+{
+}
+
+auto closed_loop_arrival::next(const task_element&, double now) -> std::optional<double>
+{
+    if (in_flight_ >= concurrency_)
+        return std::nullopt;
+
+    ++in_flight_;
+    return now + (launched_++ < concurrency_ ? offset_ : think_time_);
+}
+
+auto closed_loop_arrival::completed(double) -> void
+{
+    if (in_flight_ > 0)
+        --in_flight_;
+}
+
+auto closed_loop_arrival::reset() -> void
+{
+    in_flight_ = 0;
+    launched_ = 0;
+}
+
+
+} // namespace okec
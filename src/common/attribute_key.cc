@@ -0,0 +1,45 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/common/attribute_key.h>
+#include <unordered_set>
+
+
+namespace okec
+{
+
+namespace {
+
+struct name_hash
+{
+    using is_transparent = void;
+
+    auto operator()(std::string_view name) const noexcept -> std::size_t {
+        return attribute_key::hash_of(name);
+    }
+};
+
+} // namespace
+
+
+auto attribute_key::intern(std::string_view name) -> attribute_key
+{
+    // Nodes never move, so the views handed out stay valid.
+    static std::unordered_set<std::string, name_hash, std::equal_to<>> names;
+
+    auto it = names.find(name);
+    if (it == names.end())
+        it = names.emplace(name).first;
+
+    return attribute_key(std::string_view(*it));
+}
+
+
+} // namespace okec
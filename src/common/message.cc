@@ -9,13 +9,15 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <okec/common/message.h>
+#include <okec/network/message_header.h>
+#include <okec/utils/json_helper.hpp>
 
 namespace okec
 {
 
 message::message(ns3::Ptr<ns3::Packet> packet)
 {
-    auto j = packet_helper::to_json(packet);
+    auto j = packet_helper::to_arena_json(packet);
     if (!j.is_null())
         j_ = std::move(j);
 }
@@ -28,7 +30,7 @@ message::message(std::initializer_list<std::pair<std::string_view, std::string_v
 }
 
 message::message(const message& other)
-    : j_ { other.j_ }
+    : j_(other.j_)
 {
 }
 
@@ -81,7 +83,31 @@ auto message::type() -> std::string
 
 auto message::to_packet() -> ns3::Ptr<ns3::Packet>
 {
-    return packet_helper::make_packet(this->dump());
+    message_header header;
+    header.encoding(packet_helper::get_encoding());
+    if (auto it = j_.find("msgtype"); it != j_.end() && it->is_string())
+        header.type(message_kind_of(it->get_ref<const std::string&>()));
+
+    // 任务 ID 和分组：response 等消息直接携带，其余的在任务内容中
+    auto attribute = [this](const char* key) -> const arena_json* {
+        if (auto it = j_.find(key); it != j_.end() && it->is_string())
+            return &*it;
+        if (auto content = j_.find("content"); content != j_.end() && content->is_object()) {
+            if (auto header = content->find("header"); header != content->end() && header->is_object()) {
+                if (auto it = header->find(key); it != header->end() && it->is_string())
+                    return &*it;
+            }
+        }
+        return nullptr;
+    };
+    if (auto id = attribute("task_id"))
+        header.set_task_id(task_id::from_string(id->get_ref<const std::string&>()));
+    if (auto group = attribute("group"))
+        header.group_id(message_header::hash_group(group->get_ref<const std::string&>()));
+
+    auto packet = packet_helper::to_packet(j_);
+    packet->AddHeader(header);
+    return packet;
 }
 
 auto message::from_packet(ns3::Ptr<ns3::Packet> packet) -> message
@@ -105,8 +131,8 @@ auto message::content(const resource& r) -> void
 
 auto message::get_task_element() -> task_element
 {
-    if (!j_.is_null() && j_.contains("/content/header"_json_pointer))
-        return task_element(j_["content"]);
+    if (!j_.is_null() && json_helper::contains(j_, "content", "header"))
+        return task_element(json(j_["content"]));
     
     return task_element{nullptr};
 }
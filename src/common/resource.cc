@@ -9,7 +9,9 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <okec/common/resource.h>
+#include <okec/utils/binary_table.h>
 #include <okec/utils/format_helper.hpp>
+#include <okec/utils/json_helper.hpp>
 #include <fstream>
 #include <random>
 
@@ -40,7 +42,7 @@ auto resource::install(ns3::Ptr<ns3::Node> node) -> void
 
 resource::resource(json item) noexcept
 {
-    if (item.contains("/resource"_json_pointer)) {
+    if (json_helper::contains(item, "resource")) {
         j_ = std::move(item);
     }
 }
@@ -68,10 +70,9 @@ auto resource::set_monitor(monitor_type monitor) -> void
 auto resource::get_value(std::string_view key) const -> std::string
 {
     std::string result{};
-    json::json_pointer j_key{ "/resource/" + std::string(key) };
-    if (j_.contains(j_key))
-        j_.at(j_key).get_to(result);
-    
+    if (auto value = json_helper::find(j_, "resource", key); value && value->is_string())
+        value->get_to(result);
+
     return result;
 }
 
@@ -88,7 +89,7 @@ auto resource::dump(const int indent) -> std::string
 
 auto resource::empty() const -> bool
 {
-    return !j_.contains("/resource"_json_pointer);
+    return !json_helper::contains(j_, "resource");
 }
 
 auto resource::j_data() const -> json
@@ -98,7 +99,7 @@ auto resource::j_data() const -> json
 
 auto resource::set_data(json item) -> bool
 {
-    if (item.contains("/resource"_json_pointer)) {
+    if (json_helper::contains(item, "resource")) {
         j_ = std::move(item);
         return true;
     }
@@ -108,11 +109,12 @@ auto resource::set_data(json item) -> bool
 
 auto resource::from_msg_packet(ns3::Ptr<ns3::Packet> packet) -> resource
 {
-    json j = packet_helper::to_json(packet);
-    if (!j.is_null() && j.contains("/content/resource"_json_pointer))
-        return resource(j["content"]);
-    
-    return resource{};
+    return packet_helper::with_json(packet, [](const json& j) {
+        if (!j.is_null() && json_helper::contains(j, "content", "resource"))
+            return resource(j["content"]);
+
+        return resource{};
+    });
 }
 
 auto make_resource() -> ns3::Ptr<resource>
@@ -222,6 +224,24 @@ auto resource_container::save_to_file(const std::string& file) -> void
 
 auto resource_container::load_from_file(const std::string& file) -> bool
 {
+    if (binary_table::is_binary_file(file)) {
+        binary_table table(file);
+        if (!table.is_open() || table.kind() != binary_table::content_kind::resource || table.rows() != this->size())
+            return false;
+
+        for (auto i = 0uz; i < size(); ++i) {
+            json item;
+            item["resource"] = json::object();
+            for (auto col = 0uz; col < table.columns(); ++col) {
+                if (table.has_value(col, i))
+                    item["resource"][table.column_name(col)] = table.text(col, i);
+            }
+            m_resources[i]->set_data(std::move(item));
+        }
+
+        return true;
+    }
+
     std::ifstream fin(file);
     if (!fin.is_open())
         return false;
@@ -230,20 +250,34 @@ auto resource_container::load_from_file(const std::string& file) -> bool
     fin >> data;
 
 
-    if (!data.contains("/resource/items"_json_pointer) || data["resource"]["items"].size() != this->size())
+    if (!json_helper::contains(data, "resource", "items") || data["resource"]["items"].size() != this->size())
         return false;
     
     
-    okec::print("Items: \n");
     auto&& items = data["resource"]["items"];
     for (auto i = 0uz; i < size(); ++i) {
-        okec::print("{}\n", items[i].dump(4));
         m_resources[i]->set_data(std::move(items[i]));
     }
 
     return true;
 }
 
+auto resource_container::save_to_binary_file(const std::string& file) const -> bool
+{
+    binary_table_writer writer(binary_table::content_kind::resource, m_resources.size());
+    for (auto i = 0uz; i < m_resources.size(); ++i) {
+        for (auto it = m_resources[i]->begin(); it != m_resources[i]->end(); ++it) {
+            auto col = writer.column(it.key(), binary_table::column_kind::text);
+            if (it.value().is_string())
+                writer.set_text(col, i, it.value().get_ref<const std::string&>());
+            else
+                writer.set_text(col, i, it.value().dump());
+        }
+    }
+
+    return writer.save(file);
+}
+
 auto resource_container::set_monitor(resource::monitor_type monitor) -> void
 {
     for (const auto& item : m_resources) {
@@ -31,7 +31,7 @@ response& response::operator=(const response& other) noexcept
 }
 
 response::response(response&& other) noexcept
-    : j_{ std::move(other.j_) }
+    : j_( std::move(other.j_) ) // 花括号会把 json 包成数组
 {
 }
 
@@ -147,4 +147,59 @@ auto response::emplace_back(json item) -> void
     j_["response"]["items"].emplace_back(std::move(item));
 }
 
+auto response_tracker::expect(attributes_type values) -> void
+{
+    std::string_view id_text, group_name;
+    for (auto [key, value] : values) {
+        if (key == "task_id")
+            id_text = value;
+        else if (key == "group")
+            group_name = value;
+    }
+
+    auto id = task_id::from_string(id_text);
+    if (records_.contains(id)) {
+        log::error("response_tracker: task({}) is already expected.", id_text);
+        return;
+    }
+
+    auto& group = groups_[std::string(group_name)];
+    records_.emplace(id, record_type{ std::string(group_name), group.records.view().size() });
+    group.records.emplace_back(values);
+    ++group.unfinished;
+    ++size_;
+}
+
+auto response_tracker::find(std::string_view id) -> value_type*
+{
+    auto it = records_.find(task_id::from_string(id));
+    if (it == records_.end())
+        return nullptr;
+
+    return &groups_.at(it->second.group).records.view()[it->second.index];
+}
+
+auto response_tracker::complete(std::string_view id) -> std::optional<response>
+{
+    auto it = records_.find(task_id::from_string(id));
+    if (it == records_.end())
+        return std::nullopt;
+
+    auto group = groups_.find(it->second.group);
+    records_.erase(it);
+    if (--group->second.unfinished > 0)
+        return std::nullopt;
+
+    // 整组完成，交出记录
+    auto result = std::move(group->second.records);
+    size_ -= result.view().size();
+    groups_.erase(group);
+    return result;
+}
+
+auto response_tracker::size() const noexcept -> std::size_t
+{
+    return size_;
+}
+
 } // namespace okec
\ No newline at end of file
@@ -9,11 +9,13 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <okec/common/task.h>
+#include <okec/common/task_graph.h>
+#include <okec/common/task_source.h>
+#include <okec/utils/binary_table.h>
 #include <okec/utils/format_helper.hpp>
+#include <okec/utils/json_helper.hpp>
 #include <algorithm>
 #include <fstream>
-#include <random>
-#include <sstream>
 #include <ns3/ptr.h>
 
 
@@ -21,99 +23,136 @@
 namespace okec
 {
 
-task_element::task_element(json* item) noexcept
+task_element::task_element(std::nullptr_t) noexcept
+    : store_{ nullptr }
+    , index_{ 0 }
 {
-    if (item->contains("/header"_json_pointer)) {
-        elem_ = item; // ref
-        is_dynamically_allocated = false;
-    }
-    else
-        elem_ = nullptr;
 }
 
-task_element::task_element(json item) noexcept
+task_element::task_element(const json& item) noexcept
+    : store_{ nullptr }
+    , index_{ 0 }
 {
-    if (item.contains("/header"_json_pointer)) {
-        elem_ = new json(std::move(item)); // copy
-        is_dynamically_allocated = true;
+    if (json_helper::contains(item, "header")) {
+        owned_ = std::make_shared<task_store>();
+        index_ = owned_->push_back(item);
+        store_ = owned_.get();
     }
-    else
-        elem_ = nullptr;
 }
 
-task_element::task_element(const task_element& other) noexcept
+task_element::task_element(task_store* store, std::size_t index) noexcept
+    : store_{ store }
+    , index_{ index }
 {
-    if (this != &other) {
-        elem_ = new json(*other.elem_); // copy
-        is_dynamically_allocated = true;
+}
+
+task_element::task_element(std::shared_ptr<task_store> store, std::size_t index) noexcept
+    : store_{ store.get() }
+    , index_{ index }
+    , owned_{ std::move(store) }
+{
+}
+
+task_element::task_element(const task_element& other) noexcept
+    : store_{ other.store_ }
+    , index_{ other.index_ }
+    , owned_{ other.owned_ } // shared until one of them writes
+{
+    if (store_ && !owned_) {
+        // A reference into a task, take a snapshot of the element.
+        owned_ = std::make_shared<task_store>();
+        index_ = owned_->push_back(*other.store_, other.index_);
+        store_ = owned_.get();
     }
 }
 
 task_element& task_element::operator=(const task_element& other) noexcept
 {
     if (this != &other) {
-        elem_ = new json(*other.elem_); // copy
-        is_dynamically_allocated = true;
+        task_element temp(other);
+        *this = std::move(temp);
     }
 
     return *this;
 }
 
 task_element::task_element(task_element&& other) noexcept
-    : elem_ { std::exchange(other.elem_, nullptr) }
-    , is_dynamically_allocated { std::exchange(other.is_dynamically_allocated, false) }
+    : store_{ std::exchange(other.store_, nullptr) }
+    , index_{ std::exchange(other.index_, 0) }
+    , owned_{ std::move(other.owned_) }
 {
 }
 
 task_element& task_element::operator=(task_element&& other) noexcept
 {
-    elem_ = std::exchange(other.elem_, nullptr);
-    is_dynamically_allocated = std::exchange(other.is_dynamically_allocated, false);
+    store_ = std::exchange(other.store_, nullptr);
+    index_ = std::exchange(other.index_, 0);
+    owned_ = std::move(other.owned_);
     return *this;
 }
 
 task_element::~task_element()
 {
-    if (elem_ != nullptr && is_dynamically_allocated)
-        delete elem_;
 }
 
-auto task_element::get_header(const std::string& key) const -> std::string
+auto task_element::get_header(attribute_key key) const -> std::string
 {
-    std::string result{};
-    json::json_pointer j_key{ "/header/" + key };
-    if (elem_ && elem_->contains(j_key))
-        elem_->at(j_key).get_to(result);
-    
-    return result;
+    return store_ ? store_->get_header(index_, key) : std::string{};
 }
 
-auto task_element::set_header(std::string_view key, std::string_view value) -> bool
+auto task_element::set_header(attribute_key key, std::string_view value) -> bool
 {
-    if (elem_) {
-        json::json_pointer j_key{ "/header/" + std::string(key) };
-        (*elem_)[j_key] = value;
+    if (store_) {
+        this->detach();
+        store_->set_header(index_, key, value);
         return true;
     }
 
     return false;
 }
 
-auto task_element::get_body(const std::string& key) const -> std::string
+auto task_element::get_body(attribute_key key) const -> std::string
 {
-    std::string result{};
-    json::json_pointer j_key{ "/body/" + key };
-    if (elem_ && elem_->contains(j_key))
-        elem_->at(j_key).get_to(result);
-    
-    return result;
+    return store_ ? store_->get_body(index_, key) : std::string{};
 }
 
-auto task_element::set_body(std::string_view key, std::string_view value) -> bool
+auto task_element::set_body(attribute_key key, std::string_view value) -> bool
 {
-    if (elem_) {
-        json::json_pointer j_key{ "/body/" + std::string(key) };
-        (*elem_)[j_key] = value;
+    if (store_) {
+        this->detach();
+        store_->set_body(index_, key, value);
+        return true;
+    }
+
+    return false;
+}
+
+auto task_element::get_id() const -> task_id
+{
+    return store_ ? store_->get_id(index_) : task_id{};
+}
+
+auto task_element::set_id(task_id id) -> bool
+{
+    if (store_) {
+        this->detach();
+        store_->set_id(index_, id);
+        return true;
+    }
+
+    return false;
+}
+
+auto task_element::get_number(task_field field) const -> double
+{
+    return store_ && store_->contains(index_, field) ? store_->get_number(index_, field) : .0;
+}
+
+auto task_element::set_number(task_field field, double value) -> bool
+{
+    if (store_ && is_numeric_field(field)) {
+        this->detach();
+        store_->set_number(index_, field, value);
         return true;
     }
 
@@ -122,79 +161,105 @@ auto task_element::set_body(std::string_view key, std::string_view value) -> boo
 
 auto task_element::j_data() const -> json
 {
-    return elem_ ? *elem_ : json{};
+    return store_ ? store_->to_json(index_) : json{};
 }
 
 auto task_element::empty() const -> bool
 {
-    return elem_;
+    return store_ == nullptr;
+}
+
+auto task_element::use_count() const noexcept -> long
+{
+    return owned_.use_count();
+}
+
+auto task_element::detach() -> void
+{
+    if (owned_ && owned_.use_count() > 1) {
+        auto store = std::make_shared<task_store>();
+        index_ = store->push_back(*owned_, index_);
+        store_ = store.get();
+        owned_ = std::move(store);
+    }
 }
 
 auto task_element::from_msg_packet(ns3::Ptr<ns3::Packet> packet) -> task_element
 {
-    json j = packet_helper::to_json(packet);
-    if (!j.is_null() && j.contains("/content/header"_json_pointer))
-        return task_element(j["content"]);
-    
-    return task_element{nullptr};
+    return packet_helper::with_json(packet, [](const json& j) {
+        if (!j.is_null() && json_helper::contains(j, "content", "header"))
+            return task_element(j["content"]);
+
+        return task_element{nullptr};
+    });
 }
 
 auto task_element::dump(int indent) const -> std::string
 {
     std::string result{};
-    if (!elem_->is_null())
-        result = elem_->dump(indent);
+    if (store_)
+        result = store_->to_json(index_).dump(indent);
     return result;
 }
 
 task::task(json other)
 {
-    if (other.contains("/task/items"_json_pointer))
-        m_task = std::move(other);
+    if (json_helper::contains(other, "task", "items")) {
+        auto& items = other["task"]["items"];
+        m_store.reserve(items.size());
+        for (const auto& item : items)
+            m_store.push_back(item);
+    }
 }
 
 auto task::from_packet(ns3::Ptr<ns3::Packet> packet) -> task
 {
-    json j = packet_helper::to_json(packet);
-    return j.is_null() ? task{} : task(j);
+    return packet_helper::with_json(packet, [](const json& j) {
+        return j.is_null() ? task{} : task(j);
+    });
 }
 
 auto task::from_msg_packet(ns3::Ptr<ns3::Packet> packet) -> task
 {
-    json j = packet_helper::to_json(packet);
-    if (!j.is_null() && j.contains("/content/task"_json_pointer))
-        return task(j["content"]);
-    
-    return task{};
+    return packet_helper::with_json(packet, [](const json& j) {
+        if (!j.is_null() && json_helper::contains(j, "content", "task"))
+            return task(j["content"]);
+
+        return task{};
+    });
 }
 
 auto task::emplace_back(task_header header_attrs, task_body body_attrs) -> void
 {
-    json item;
+    auto index = m_store.push_back();
     // Set header attributes
-    for (auto [key, value] : header_attrs) {
-        item["header"][key] = value;
+    for (const auto& [key, value] : header_attrs) {
+        m_store.set_header(index, key, value);
     }
 
     // Set body attributes
-    for (auto [key, value] : body_attrs) {
-        item["body"][key] = value;
+    for (const auto& [key, value] : body_attrs) {
+        m_store.set_body(index, key, value);
     }
+}
 
-    m_task["task"]["items"].emplace_back(std::move(item));
+auto task::push_back(const task_element& item) -> void
+{
+    if (item.store_)
+        m_store.push_back(*item.store_, item.index_);
 }
 
 auto task::dump(int indent) const -> std::string
 {
-    return m_task.dump(indent);
+    return this->j_data().dump(indent);
 }
 
 auto task::elements_view() -> std::vector<task_element>
 {
     std::vector<task_element> items;
     items.reserve(this->size());
-    for (json& item : m_task["task"]["items"])
-        items.emplace_back(task_element(&item));
+    for (std::size_t i = 0; i < m_store.size(); ++i)
+        items.emplace_back(&m_store, i);
 
     return items;
 }
@@ -204,74 +269,74 @@ auto task::elements() const -> std::vector<task_element>
     std::vector<task_element> items;
     items.reserve(this->size());
 
-    for (const json& item : m_task["task"]["items"])
-        items.emplace_back(task_element(item));
+    // All elements share one snapshot of the task, an element is only copied
+    // out of it when it is modified.
+    auto snapshot = std::make_shared<task_store>(m_store);
+    for (std::size_t i = 0; i < m_store.size(); ++i)
+        items.push_back(task_element(snapshot, i));
 
     return items;
 }
 
 auto task::at(std::size_t index) noexcept -> task_element
 {
-    return task_element(&m_task["task"]["items"].at(index));
+    return task_element(&m_store, index);
 }
 
 auto task::at(std::size_t index) const noexcept -> task_element
 {
-    return task_element(m_task["task"]["items"].at(index));
+    auto store = std::make_shared<task_store>();
+    auto i = store->push_back(m_store, index); // copy
+    return task_element(std::move(store), i);
 }
 
 auto task::data() const -> json
 {
-    return m_task["task"]["items"];
+    json items = json::array();
+    for (std::size_t i = 0; i < m_store.size(); ++i)
+        items.emplace_back(m_store.to_json(i));
+
+    return items;
 }
 
 auto task::j_data() const -> json
 {
-    return m_task;
+    json result;
+    if (!m_store.empty())
+        result["task"]["items"] = this->data();
+
+    return result;
 }
 
 auto task::is_null() const -> bool
 {
-    return m_task.is_null();
+    return m_store.empty();
 }
 
 auto task::size() const -> std::size_t
 {
-    if (m_task.contains("/task/items"_json_pointer))
-        return m_task["task"]["items"].size();
-
-    return 0;
+    return m_store.size();
 }
 
-auto task::set_if(attributes_t values, auto f) -> void
+auto task::empty() -> bool
 {
-    for (auto& item : m_task["task"]["items"]) {
-        bool cond{true};
-        for (auto [key, value] : values) {
-            if (item[key] != value)
-                cond = false;
-        }
-
-        if (cond) {
-            f(item);
-            break;
-        }
-    }
+    return m_store.empty();
 }
 
 auto task::find_if(attributes_t values) -> task
 {
     task result{};
-    for (const auto& item : m_task["task"]["items"]) {
-        bool cond{true};
-        for (auto [key, value] : values) {
-            if (item[key] != value)
-                cond = false;
+    if (auto bucket = this->candidates(values)) {
+        for (auto i : *bucket) {
+            if (this->match(i, values))
+                result.m_store.push_back(m_store, i);
         }
+        return result;
+    }
 
-        if (cond) {
-            result.push_back(item);
-        }
+    for (std::size_t i = 0; i < m_store.size(); ++i) {
+        if (this->match(i, values))
+            result.m_store.push_back(m_store, i);
     }
     return result;
 }
@@ -283,9 +348,15 @@ auto task::find_if(attribute_t value) -> task
 // status 0
 auto task::contains(attributes_t values) -> bool
 {
-    for (auto& item : m_task["task"]["items"]) {
-        for (auto [key, value] : values) {
-            if (item["header"][key] == value)
+    for (const auto& [key, value] : values) {
+        if (auto bucket = m_store.lookup(key, value)) {
+            if (!bucket->empty())
+                return true;
+            continue;
+        }
+
+        for (std::size_t i = 0; i < m_store.size(); ++i) {
+            if (m_store.get_header(i, key) == value)
                 return true;
         }
     }
@@ -298,67 +369,69 @@ auto task::contains(attribute_t value) -> bool
     return contains({value});
 }
 
-auto task::get_header(const json& element, const std::string& key) -> std::string
+auto task::create_index(attribute_key key) -> void
+{
+    m_store.create_index(key);
+}
+
+auto task::next_pending() noexcept -> task_element
+{
+    auto& pending = m_store.pending();
+    return pending.empty() ? task_element{nullptr} : this->at(*pending.begin());
+}
+
+auto task::add_dependency(std::size_t successor, std::size_t predecessor) -> void
+{
+    auto key = std::string(dependency_key);
+    auto value = m_store.get_header(successor, key);
+    if (!value.empty())
+        value += ',';
+    value += m_store.get_id(predecessor).to_string();
+    m_store.set_header(successor, key, value);
+}
+
+auto task::get_header(const json& element, attribute_key key) -> std::string
 {
     std::string result{};
-    json::json_pointer j_key{ "/header/" + key };
-    if (element.contains(j_key))
-        element.at(j_key).get_to(result);
-    
+    if (auto value = json_helper::find(element, "header", key.name()); value && value->is_string())
+        value->get_to(result);
+
     return result;
 }
 
-auto task::get_body(const json& element, const std::string& key) -> std::string
+auto task::get_body(const json& element, attribute_key key) -> std::string
 {
     std::string result{};
-    json::json_pointer j_key{ "/body/" + key };
-    if (element.contains(j_key))
-        element.at(j_key).get_to(result);
-    
+    if (auto value = json_helper::find(element, "body", key.name()); value && value->is_string())
+        value->get_to(result);
+
     return result;
 }
 
 auto task::unique_id() -> std::string
 {
-    static std::random_device              rd;
-    static std::mt19937                    gen(rd());
-    static std::uniform_int_distribution<> dis(0, 15);
-    static std::uniform_int_distribution<> dis2(8, 11);
-
-    std::stringstream ss;
-    int i;
-    ss << std::hex << std::uppercase;
-    for (i = 0; i < 8; i++) {
-        ss << dis(gen);
-    }
-    // ss << "-";
-    for (i = 0; i < 4; i++) {
-        ss << dis(gen);
-    }
-    // ss << "-4";
-    for (i = 0; i < 3; i++) {
-        ss << dis(gen);
-    }
-    // ss << "-";
-    ss << dis2(gen);
-    for (i = 0; i < 3; i++) {
-        ss << dis(gen);
-    }
-    // ss << "-";
-    for (i = 0; i < 12; i++) {
-        ss << dis(gen);
-    };
-    return ss.str();
+    return task_id::generate().to_string();
 }
 
 auto task::save_to_file(const std::string& file_name) -> void
 {
     std::ofstream fout(file_name);
-    fout << std::setw(4) << m_task << std::endl;
+    fout << std::setw(4) << this->j_data() << std::endl;
 }
 
 auto task::load_from_file(const std::string& file_name) -> bool
 {
+    if (binary_table::is_binary_file(file_name)) {
+        binary_task_source source(file_name);
+        if (!source.is_open())
+            return false;
+
+        task result;
+        source.read(result, source.rows());
+        *this = std::move(result);
+        return true;
+    }
+
     std::ifstream fin(file_name);
     if (!fin.is_open())
         return false;
@@ -366,13 +439,50 @@ auto task::load_from_file(const std::string& file_name) -> bool
     json data;
     fin >> data;
 
-    if (!data.contains("/task/items"_json_pointer))
+    if (!json_helper::contains(data, "task", "items"))
         return false;
     
-    m_task = std::move(data);
+    *this = task(std::move(data));
     return true;
 }
 
+auto task::save_to_binary_file(const std::string& file_name) const -> bool
+{
+    using column_kind = binary_table::column_kind;
+
+    binary_table_writer writer(binary_table::content_kind::task, m_store.size());
+    for (std::size_t i = 0; i < task_field_names.size(); ++i) {
+        auto field = static_cast<task_field>(i);
+        auto kind = field == task_field::task_id ? column_kind::id
+                  : is_numeric_field(field)      ? column_kind::number
+                  :                                column_kind::text;
+        std::optional<std::size_t> col;
+        for (std::size_t row = 0; row < m_store.size(); ++row) {
+            if (!m_store.contains(row, field))
+                continue;
+            if (!col)
+                col = writer.column(task_field_names[i], kind);
+
+            if (kind == column_kind::id)
+                writer.set_id(*col, row, m_store.get_id(row));
+            else if (kind == column_kind::number)
+                writer.set_number(*col, row, m_store.get_number(row, field));
+            else
+                writer.set_text(*col, row, m_store.get_text(row, field));
+        }
+    }
+
+    // user-defined attributes, and well-known ones holding non-numeric text
+    for (std::size_t row = 0; row < m_store.size(); ++row) {
+        for (const auto& [key, value] : m_store.headers(row))
+            writer.set_text(writer.column(key, column_kind::text, 0), row, value);
+        for (const auto& [key, value] : m_store.bodies(row))
+            writer.set_text(writer.column(key, column_kind::text, 1), row, value);
+    }
+
+    return writer.save(file_name);
+}
+
 auto task::operator[](std::size_t index) noexcept -> task_element
 {
     return this->at(index);
@@ -383,9 +493,54 @@ auto task::operator[](std::size_t index) const noexcept -> task_element
     return this->at(index);
 }
 
-auto task::push_back(const json &sub) -> void
+auto task::store() noexcept -> task_store&
+{
+    return m_store;
+}
+
+auto task::store() const noexcept -> const task_store&
+{
+    return m_store;
+}
+
+auto task::match(std::size_t index, attributes_t values) const -> bool
+{
+    for (const auto& [key, value] : values) {
+        if (m_store.get_header(index, key) != value)
+            return false;
+    }
+
+    return true;
+}
+
+// Smallest index bucket among the indexed attributes, or nullptr if none is indexed.
+auto task::candidates(attributes_t values) const -> const task_store::bucket_type*
+{
+    const task_store::bucket_type* result = nullptr;
+    for (const auto& [key, value] : values) {
+        auto bucket = m_store.lookup(key, value);
+        if (bucket && (!result || bucket->size() < result->size()))
+            result = bucket;
+    }
+
+    return result;
+}
+
+auto task::first_match(attributes_t values) const -> std::optional<std::size_t>
 {
-    m_task.push_back(sub);
+    if (auto bucket = this->candidates(values)) {
+        for (auto i : *bucket) {
+            if (this->match(i, values))
+                return i;
+        }
+        return std::nullopt;
+    }
+
+    for (std::size_t i = 0; i < m_store.size(); ++i) {
+        if (this->match(i, values))
+            return i;
+    }
+    return std::nullopt;
 }
 
 
@@ -0,0 +1,301 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/common/task_graph.h>
+#include <okec/utils/log.h>
+#include <algorithm>
+#include <optional>
+#include <ranges>
+
+
+namespace okec
+{
+
+auto dependencies_of(const task_element& item) -> std::vector<task_id>
+{
+    std::vector<task_id> result;
+    auto value = item.get_header(std::string(dependency_key));
+    for (auto part : std::views::split(std::string_view(value), ',')) {
+        std::string_view id(part.begin(), part.end());
+        if (!id.empty())
+            result.push_back(task_id::from_string(id));
+    }
+
+    return result;
+}
+
+task_graph::task_graph(const task& t)
+    : predecessors_(t.size())
+    , successors_(t.size())
+{
+    const auto& store = t.store();
+
+    std::unordered_map<task_id, std::size_t> index_of;
+    index_of.reserve(store.size());
+    for (std::size_t i = 0; i < store.size(); ++i)
+        index_of.emplace(store.get_id(i), i);
+
+    for (std::size_t i = 0; i < store.size(); ++i) {
+        for (const auto& id : dependencies_of(t[i])) {
+            if (auto it = index_of.find(id); it != index_of.end() && it->second != i) {
+                predecessors_[i].push_back(it->second);
+                successors_[it->second].push_back(i);
+            }
+        }
+    }
+
+    // Kahn's algorithm, ties broken by element order.
+    std::vector<std::size_t> in_degree(size());
+    for (std::size_t i = 0; i < size(); ++i)
+        in_degree[i] = predecessors_[i].size();
+
+    order_.reserve(size());
+    for (std::size_t i = 0; i < size(); ++i) {
+        if (in_degree[i] == 0)
+            order_.push_back(i);
+    }
+
+    for (std::size_t head = 0; head < order_.size(); ++head) {
+        for (auto next : successors_[order_[head]]) {
+            if (--in_degree[next] == 0)
+                order_.push_back(next);
+        }
+    }
+
+    if (order_.size() != size()) {
+        log::error("task_graph: the dependencies of the task contain a cycle.");
+        order_.clear();
+    }
+}
+
+auto task_graph::size() const noexcept -> std::size_t
+{
+    return predecessors_.size();
+}
+
+auto task_graph::predecessors(std::size_t index) const -> const std::vector<std::size_t>&
+{
+    return predecessors_[index];
+}
+
+auto task_graph::successors(std::size_t index) const -> const std::vector<std::size_t>&
+{
+    return successors_[index];
+}
+
+auto task_graph::is_acyclic() const noexcept -> bool
+{
+    return order_.size() == size();
+}
+
+auto task_graph::topological_order() const -> const std::vector<std::size_t>&
+{
+    return order_;
+}
+
+auto task_graph::upward_ranks(cost_type cost, edge_cost_type comm) const -> std::vector<double>
+{
+    std::vector<double> ranks(size());
+    for (auto i : order_ | std::views::reverse) {
+        double longest{};
+        for (auto next : successors_[i])
+            longest = std::max(longest, (comm ? comm(i, next) : .0) + ranks[next]);
+        ranks[i] = cost(i) + longest;
+    }
+
+    return ranks;
+}
+
+auto task_graph::critical_path(cost_type cost, edge_cost_type comm) const -> std::vector<std::size_t>
+{
+    std::vector<std::size_t> path;
+    if (order_.empty())
+        return path;
+
+    auto ranks = this->upward_ranks(cost, comm);
+
+    // Start at the highest ranked entry and follow the successor that determined each rank.
+    std::optional<std::size_t> current;
+    for (std::size_t i = 0; i < size(); ++i) {
+        if (predecessors_[i].empty() && (!current || ranks[i] > ranks[*current]))
+            current = i;
+    }
+
+    while (current) {
+        path.push_back(*current);
+        auto i = *current;
+        current.reset();
+        for (auto next : successors_[i]) {
+            auto length = (comm ? comm(i, next) : .0) + ranks[next];
+            if (!current || length > (comm ? comm(i, *current) : .0) + ranks[*current])
+                current = next;
+        }
+    }
+
+    return path;
+}
+
+auto dependency_tracker::submit(task_element item, task_queue& ready) -> std::optional<task_element>
+{
+    if (item.get_header(keys::task_id).empty())
+        item.set_id(task_id::generate()); // 同 task_queue::push
+
+    auto id = item.get_id();
+    auto predecessors = dependencies_of(item);
+    if (std::ranges::any_of(predecessors, [this](const task_id& pred) { return failed_.contains(pred); })) {
+        failed_.insert(id);
+        return item;
+    }
+
+    // 环上的任务互相等待，永远不会就绪
+    if (this->closes_cycle(id, predecessors)) {
+        log::error("dependency_tracker: task({}) closes a dependency cycle.", item.get_header(keys::task_id));
+        failed_.insert(id);
+        return item;
+    }
+
+    std::size_t unmet{};
+    for (const auto& pred : predecessors) {
+        if (pred != id && !completed_.contains(pred)) {
+            successors_[pred].push_back(id);
+            ++unmet;
+        }
+    }
+
+    if (unmet == 0)
+        ready.push(std::move(item));
+    else
+        waiting_.insert_or_assign(id, waiting_item{ std::move(item), unmet });
+
+    return std::nullopt;
+}
+
+auto dependency_tracker::complete(const task_id& id, task_queue& ready) -> std::size_t
+{
+    if (!completed_.insert(id).second)
+        return 0;
+
+    auto it = successors_.find(id);
+    if (it == successors_.end())
+        return 0;
+
+    std::size_t released{};
+    for (const auto& next : it->second) {
+        auto waiting = waiting_.find(next);
+        if (waiting != waiting_.end() && --waiting->second.unmet == 0) {
+            ready.push(std::move(waiting->second.item));
+            waiting_.erase(waiting);
+            ++released;
+        }
+    }
+
+    successors_.erase(it);
+    return released;
+}
+
+auto dependency_tracker::fail(const task_id& id) -> std::vector<task_element>
+{
+    std::vector<task_element> failed;
+    std::vector<task_id> pending{ id };
+    while (!pending.empty()) {
+        auto current = pending.back();
+        pending.pop_back();
+        failed_.insert(current);
+
+        auto it = successors_.find(current);
+        if (it == successors_.end())
+            continue;
+
+        for (const auto& next : it->second) {
+            auto waiting = waiting_.find(next);
+            if (waiting == waiting_.end())
+                continue;
+
+            failed.push_back(std::move(waiting->second.item));
+            waiting_.erase(waiting);
+            pending.push_back(next);
+        }
+
+        successors_.erase(it);
+    }
+
+    return failed;
+}
+
+auto dependency_tracker::take_waiting() -> std::vector<task_element>
+{
+    std::vector<task_element> failed;
+    failed.reserve(waiting_.size());
+    for (auto& [id, waiting] : waiting_) {
+        failed_.insert(id);
+        failed.push_back(std::move(waiting.item));
+    }
+
+    waiting_.clear();
+    successors_.clear();
+    return failed;
+}
+
+auto dependency_tracker::closes_cycle(const task_id& id, const std::vector<task_id>& predecessors) const -> bool
+{
+    // 沿等待中的前驱向上查找，只访问尚未完成的任务
+    std::vector<task_id> pending;
+    for (const auto& pred : predecessors) {
+        if (pred != id && !completed_.contains(pred))
+            pending.push_back(pred);
+    }
+
+    std::unordered_set<task_id> visited;
+    while (!pending.empty()) {
+        auto current = pending.back();
+        pending.pop_back();
+        if (current == id)
+            return true;
+        if (!visited.insert(current).second)
+            continue;
+
+        auto it = waiting_.find(current);
+        if (it == waiting_.end())
+            continue;
+
+        for (const auto& pred : dependencies_of(it->second.item)) {
+            if (pred != current && !completed_.contains(pred))
+                pending.push_back(pred);
+        }
+    }
+
+    return false;
+}
+
+auto dependency_tracker::is_completed(const task_id& id) const -> bool
+{
+    return completed_.contains(id);
+}
+
+auto dependency_tracker::is_failed(const task_id& id) const -> bool
+{
+    return failed_.contains(id);
+}
+
+auto dependency_tracker::waiting() const noexcept -> std::size_t
+{
+    return waiting_.size();
+}
+
+auto dependency_tracker::clear() -> void
+{
+    completed_.clear();
+    failed_.clear();
+    waiting_.clear();
+    successors_.clear();
+}
+
+
+} // namespace okec
@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/common/task_id.h>
+#include <random>
+
+
+namespace okec
+{
+
+namespace {
+
+// splitmix64, see https://prng.di.unimi.it/splitmix64.c
+struct splitmix64 {
+    std::uint64_t state;
+
+    auto operator()() noexcept -> std::uint64_t {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+};
+
+auto generator() -> splitmix64& {
+    static splitmix64 gen{ (static_cast<std::uint64_t>(std::random_device{}()) << 32) | std::random_device{}() };
+    return gen;
+}
+
+constexpr auto hex_value(char c) noexcept -> int {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// FNV-1a followed by a splitmix finalizer, for non-canonical ids.
+auto hash_text(std::string_view sv, std::uint64_t basis) noexcept -> std::uint64_t {
+    std::uint64_t h = basis;
+    for (unsigned char c : sv) {
+        h ^= c;
+        h *= 0x100000001B3ull;
+    }
+    return splitmix64{ h }();
+}
+
+} // namespace
+
+auto task_id::generate() -> task_id
+{
+    auto& gen = generator();
+    auto high = gen();
+    return task_id{ high, gen() };
+}
+
+auto task_id::seed(std::uint64_t value) -> void
+{
+    generator().state = value;
+}
+
+auto task_id::from_string(std::string_view sv) noexcept -> task_id
+{
+    if (!is_canonical(sv))
+        return task_id{ hash_text(sv, 0xCBF29CE484222325ull), hash_text(sv, 0x84222325CBF29CE4ull) };
+
+    std::uint64_t high{}, low{};
+    for (std::size_t i = 0; i < 16; ++i)
+        high = (high << 4) | hex_value(sv[i]);
+    for (std::size_t i = 16; i < 32; ++i)
+        low = (low << 4) | hex_value(sv[i]);
+
+    return task_id{ high, low };
+}
+
+auto task_id::is_canonical(std::string_view sv) noexcept -> bool
+{
+    if (sv.size() != 32)
+        return false;
+
+    for (char c : sv) {
+        if (hex_value(c) < 0)
+            return false;
+    }
+
+    return true;
+}
+
+auto task_id::to_string() const -> std::string
+{
+    constexpr char digits[] = "0123456789ABCDEF";
+    std::string result(32, '0');
+    for (std::size_t i = 0; i < 16; ++i) {
+        result[15 - i] = digits[(high_ >> (i * 4)) & 0xF];
+        result[31 - i] = digits[(low_ >> (i * 4)) & 0xF];
+    }
+
+    return result;
+}
+
+
+} // namespace okec
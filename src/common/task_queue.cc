@@ -0,0 +1,207 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/common/task_queue.h>
+#include <okec/utils/log.h>
+
+
+namespace okec
+{
+
+task_queue::task_queue(queue_policy policy)
+    : policy_{ policy }
+{
+}
+
+auto task_queue::set_policy(queue_policy policy, priority_type priority) -> void
+{
+    policy_ = policy;
+    priority_ = std::move(priority);
+
+    ready_.clear();
+    parked_.clear();
+    for (auto& [id, e] : tasks_) {
+        e.order.first = key_of(e.item);
+        if (e.where == state::ready)
+            ready_.emplace(e.order, id);
+        else if (e.where == state::parked)
+            parked_.emplace(park_key{ e.demand, e.order }, id);
+    }
+}
+
+auto task_queue::policy() const noexcept -> queue_policy
+{
+    return policy_;
+}
+
+auto task_queue::push(task_element item) -> bool
+{
+    // 没有 id 的任务都会得到空字符串的哈希值，彼此冲突
+    if (item.get_header(keys::task_id).empty())
+        item.set_id(task_id::generate());
+
+    auto id = item.get_id();
+    if (tasks_.contains(id)) {
+        log::error("task_queue: task({}) is already queued, the duplicate is dropped.", item.get_header(keys::task_id));
+        return false;
+    }
+
+    order_key order{ key_of(item), sequence_++ };
+    tasks_.emplace(id, entry{ std::move(item), order, state::ready, .0 });
+    ready_.emplace(order, id);
+    return true;
+}
+
+auto task_queue::front() noexcept -> task_element*
+{
+    return ready_.empty() ? nullptr : &tasks_.find(ready_.begin()->second)->second.item;
+}
+
+auto task_queue::ready_items() -> std::vector<task_element*>
+{
+    std::vector<task_element*> items;
+    items.reserve(ready_.size());
+    for (const auto& [order, id] : ready_)
+        items.push_back(&tasks_.find(id)->second.item);
+
+    return items;
+}
+
+auto task_queue::dispatch(const task_id& id) -> bool
+{
+    auto it = tasks_.find(id);
+    if (it == tasks_.end() || it->second.where != state::ready)
+        return false;
+
+    ready_.erase(it->second.order);
+    it->second.where = state::in_flight;
+    it->second.item.set_number(task_field::status, 1);
+    return true;
+}
+
+auto task_queue::requeue(const task_id& id) -> bool
+{
+    auto it = tasks_.find(id);
+    if (it == tasks_.end() || it->second.where != state::in_flight)
+        return false;
+
+    it->second.where = state::ready;
+    it->second.item.set_number(task_field::status, 0);
+    ready_.emplace(it->second.order, id);
+    return true;
+}
+
+auto task_queue::park(const task_id& id, double demand) -> bool
+{
+    auto it = tasks_.find(id);
+    if (it == tasks_.end() || it->second.where != state::ready)
+        return false;
+
+    ready_.erase(it->second.order);
+    it->second.where = state::parked;
+    it->second.demand = demand;
+    parked_.emplace(park_key{ demand, it->second.order }, id);
+    return true;
+}
+
+auto task_queue::wake(double capacity) -> std::size_t
+{
+    std::size_t woken{};
+    for (auto it = parked_.begin(); it != parked_.end() && it->first.first <= capacity; it = parked_.erase(it)) {
+        tasks_.at(it->second).where = state::ready;
+        ready_.emplace(it->first.second, it->second);
+        ++woken;
+    }
+
+    return woken;
+}
+
+auto task_queue::take_parked() -> std::vector<task_element>
+{
+    std::vector<task_element> items;
+    items.reserve(parked_.size());
+    for (const auto& [key, id] : parked_) {
+        auto it = tasks_.find(id);
+        items.push_back(std::move(it->second.item));
+        tasks_.erase(it);
+    }
+
+    parked_.clear();
+    return items;
+}
+
+auto task_queue::erase(const task_id& id) -> std::optional<task_element>
+{
+    auto it = tasks_.find(id);
+    if (it == tasks_.end())
+        return std::nullopt;
+
+    if (it->second.where == state::ready)
+        ready_.erase(it->second.order);
+    else if (it->second.where == state::parked)
+        parked_.erase(park_key{ it->second.demand, it->second.order });
+
+    auto item = std::move(it->second.item);
+    tasks_.erase(it);
+    return item;
+}
+
+auto task_queue::find(const task_id& id) noexcept -> task_element*
+{
+    auto it = tasks_.find(id);
+    return it != tasks_.end() ? &it->second.item : nullptr;
+}
+
+auto task_queue::size() const noexcept -> std::size_t
+{
+    return tasks_.size();
+}
+
+auto task_queue::empty() const noexcept -> bool
+{
+    return tasks_.empty();
+}
+
+auto task_queue::ready() const noexcept -> std::size_t
+{
+    return ready_.size();
+}
+
+auto task_queue::parked() const noexcept -> std::size_t
+{
+    return parked_.size();
+}
+
+auto task_queue::in_flight() const noexcept -> std::size_t
+{
+    return tasks_.size() - ready_.size() - parked_.size();
+}
+
+auto task_queue::clear() -> void
+{
+    tasks_.clear();
+    ready_.clear();
+    parked_.clear();
+}
+
+auto task_queue::key_of(const task_element& item) const -> double
+{
+    switch (policy_) {
+    case queue_policy::edf:
+        return item.get_number(task_field::arrival_time) + item.get_number(task_field::deadline);
+    case queue_policy::priority:
+        return priority_ ? -priority_(item) : .0;
+    default:
+        return .0;
+    }
+}
+
+
+} // namespace okec
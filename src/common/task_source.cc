@@ -0,0 +1,155 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/common/task_source.h>
+#include <okec/utils/log.h>
+#include <algorithm>
+
+
+namespace okec
+{
+
+ndjson_task_source::ndjson_task_source(const std::string& file_name)
+    : m_file(file_name)
+{
+}
+
+auto ndjson_task_source::is_open() const -> bool
+{
+    return m_file.is_open();
+}
+
+auto ndjson_task_source::read(task& t, std::size_t n) -> std::size_t
+{
+    std::size_t count{};
+    std::string line;
+    while (count < n && std::getline(m_file, line)) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
+
+        auto item = json::parse(line, nullptr, false);
+        if (item.is_discarded() || !item.contains("header")) {
+            log::warning("ndjson_task_source: skipping invalid line: {}", line);
+            continue;
+        }
+
+        t.store().push_back(item);
+        ++count;
+    }
+
+    return count;
+}
+
+binary_task_source::binary_task_source(const std::string& file_name)
+{
+    if (!binary_table::is_binary_file(file_name))
+        return;
+
+    m_table = binary_table(file_name);
+    if (!m_table.is_open() || m_table.kind() != binary_table::content_kind::task)
+        return;
+
+    m_fields.resize(m_table.columns());
+    for (std::size_t col = 0; col < m_table.columns(); ++col) {
+        if (m_table.get_column_kind(col) != binary_table::column_kind::number)
+            continue;
+
+        auto field = task_store::field_of(m_table.column_name(col));
+        if (!field || !is_numeric_field(*field)) {
+            log::warning("binary_task_source: unknown numeric column: {}", m_table.column_name(col));
+            return;
+        }
+        m_fields[col] = field;
+    }
+
+    m_valid = true;
+}
+
+auto binary_task_source::is_open() const -> bool
+{
+    return m_valid;
+}
+
+auto binary_task_source::rows() const noexcept -> std::size_t
+{
+    return m_valid ? m_table.rows() : 0;
+}
+
+auto binary_task_source::read(task& t, std::size_t n) -> std::size_t
+{
+    auto count = std::min(n, this->rows() - m_row);
+    if (!count)
+        return 0;
+
+    auto& store = t.store();
+    auto base = store.size();
+    store.reserve(base + count);
+    for (std::size_t i = 0; i < count; ++i)
+        store.push_back();
+
+    // 按列复制，每列只访问当前块对应的那段映射内存
+    for (std::size_t col = 0; col < m_table.columns(); ++col) {
+        auto name = m_table.column_name(col);
+        switch (m_table.get_column_kind(col)) {
+        case binary_table::column_kind::id:
+            for (std::size_t i = 0; i < count; ++i) {
+                if (m_table.has_value(col, m_row + i))
+                    store.set_id(base + i, m_table.id(col, m_row + i));
+            }
+            break;
+        case binary_table::column_kind::number: {
+            auto numbers = m_table.numbers(col);
+            for (std::size_t i = 0; i < count; ++i) {
+                if (m_table.has_value(col, m_row + i))
+                    store.set_number(base + i, *m_fields[col], numbers[m_row + i]);
+            }
+            break;
+        }
+        case binary_table::column_kind::text:
+            for (std::size_t i = 0; i < count; ++i) {
+                if (!m_table.has_value(col, m_row + i))
+                    continue;
+                if (m_table.column_section(col) == 0)
+                    store.set_header(base + i, name, m_table.text(col, m_row + i));
+                else
+                    store.set_body(base + i, name, m_table.text(col, m_row + i));
+            }
+            break;
+        }
+    }
+
+    m_row += count;
+    return count;
+}
+
+generator_task_source::generator_task_source(generator_type generator)
+    : m_generator(std::move(generator))
+{
+}
+
+auto generator_task_source::read(task& t, std::size_t n) -> std::size_t
+{
+    std::size_t count{};
+    while (count < n && m_generator) {
+        auto item = m_generator();
+        if (item.empty()) {
+            m_generator = nullptr;
+            break;
+        }
+
+        t.push_back(item);
+        ++count;
+    }
+
+    return count;
+}
+
+
+} // namespace okec
@@ -0,0 +1,422 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/common/task_store.h>
+#include <algorithm>
+#include <charconv>
+
+
+namespace okec
+{
+
+auto task_store::size() const noexcept -> size_type
+{
+    return present_.size();
+}
+
+auto task_store::empty() const noexcept -> bool
+{
+    return present_.empty();
+}
+
+auto task_store::reserve(size_type n) -> void
+{
+    ids_.reserve(n);
+    for (auto& column : texts_)
+        column.reserve(n);
+    for (auto& column : numbers_)
+        column.reserve(n);
+    present_.reserve(n);
+    headers_.reserve(n);
+    bodies_.reserve(n);
+}
+
+auto task_store::clear() -> void
+{
+    ids_.clear();
+    for (auto& column : texts_)
+        column.clear();
+    for (auto& column : numbers_)
+        column.clear();
+    present_.clear();
+    headers_.clear();
+    bodies_.clear();
+
+    for (auto& [key, idx] : indexes_)
+        idx.clear();
+    pending_.clear();
+}
+
+auto task_store::push_back() -> size_type
+{
+    ids_.emplace_back();
+    for (auto& column : texts_)
+        column.emplace_back();
+    for (auto& column : numbers_)
+        column.emplace_back();
+    present_.emplace_back();
+    headers_.emplace_back();
+    bodies_.emplace_back();
+
+    auto index = size() - 1;
+    for (auto& [key, idx] : indexes_)
+        idx[std::string{}].insert(index); // every attribute reads as empty
+    return index;
+}
+
+auto task_store::append(size_type n) -> size_type
+{
+    auto first = size();
+    auto count = first + n;
+    ids_.resize(count);
+    for (auto& column : texts_)
+        column.resize(count);
+    for (auto& column : numbers_)
+        column.resize(count);
+    present_.resize(count);
+    headers_.resize(count);
+    bodies_.resize(count);
+
+    for (auto& [key, idx] : indexes_) {
+        auto& bucket = idx[std::string{}];
+        for (auto i = first; i < count; ++i)
+            bucket.insert(bucket.end(), i);
+    }
+
+    return first;
+}
+
+auto task_store::push_back(const task_store& other, size_type index) -> size_type
+{
+    ids_.push_back(other.ids_[index]);
+    for (std::size_t i = 0; i < text_columns; ++i)
+        texts_[i].push_back(other.texts_[i][index]);
+    for (std::size_t i = 0; i < number_columns; ++i)
+        numbers_[i].push_back(other.numbers_[i][index]);
+    present_.push_back(other.present_[index]);
+    headers_.push_back(other.headers_[index]);
+    bodies_.push_back(other.bodies_[index]);
+
+    auto new_index = size() - 1;
+    this->index_row(new_index);
+    return new_index;
+}
+
+auto task_store::push_back(const json& item) -> size_type
+{
+    auto index = this->push_back();
+
+    if (auto it = item.find("header"); it != item.end() && it->is_object()) {
+        for (auto attr = it->begin(); attr != it->end(); ++attr) {
+            if (attr->is_string())
+                this->set_header(index, attr.key(), attr->get_ref<const std::string&>());
+            else
+                this->set_header(index, attr.key(), attr->dump());
+        }
+    }
+
+    if (auto it = item.find("body"); it != item.end() && it->is_object()) {
+        for (auto attr = it->begin(); attr != it->end(); ++attr) {
+            if (attr->is_string())
+                this->set_body(index, attr.key(), attr->get_ref<const std::string&>());
+            else
+                this->set_body(index, attr.key(), attr->dump());
+        }
+    }
+
+    return index;
+}
+
+auto task_store::get_header(size_type index, attribute_key key) const -> std::string
+{
+    if (auto field = key.field(); field && contains(index, *field)) {
+        if (*field == task_field::task_id)
+            return ids_[index].to_string();
+
+        return is_numeric_field(*field)
+            ? format_number(numbers_[number_column(*field)][index])
+            : texts_[text_column(*field)][index];
+    }
+
+    auto attr = find(headers_[index], key);
+    return attr ? attr->second : std::string{};
+}
+
+auto task_store::set_header(size_type index, attribute_key key, std::string_view value) -> void
+{
+    auto idx = find_index(key);
+    if (idx)
+        unindex(*idx, index, get_header(index, key));
+
+    this->write_header(index, key, value);
+
+    if (idx)
+        (*idx)[get_header(index, key)].insert(index);
+    if (key.is(task_field::status))
+        this->update_pending(index);
+}
+
+auto task_store::write_header(size_type index, attribute_key key, std::string_view value) -> void
+{
+    auto field = key.field();
+    if (!field) {
+        assign(headers_[index], key, value);
+        return;
+    }
+
+    if (is_text_field(*field)) {
+        texts_[text_column(*field)][index] = value;
+        set_present(index, *field, true);
+        return;
+    }
+
+    if (*field == task_field::task_id) {
+        if (task_id::is_canonical(value)) {
+            ids_[index] = task_id::from_string(value);
+            set_present(index, *field, true);
+            erase(headers_[index], key);
+        } else {
+            // Keep user-defined ids verbatim, get_id() hashes them.
+            set_present(index, *field, false);
+            assign(headers_[index], key, value);
+        }
+        return;
+    }
+
+    double number{};
+    auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), number);
+    if (ec == std::errc{} && ptr == value.data() + value.size()) {
+        numbers_[number_column(*field)][index] = number;
+        set_present(index, *field, true);
+        erase(headers_[index], key);
+    } else {
+        // Not a number, keep the raw text so nothing is lost.
+        set_present(index, *field, false);
+        assign(headers_[index], key, value);
+    }
+}
+
+auto task_store::get_body(size_type index, attribute_key key) const -> std::string
+{
+    auto attr = find(bodies_[index], key);
+    return attr ? attr->second : std::string{};
+}
+
+auto task_store::set_body(size_type index, attribute_key key, std::string_view value) -> void
+{
+    assign(bodies_[index], key, value);
+}
+
+auto task_store::contains(size_type index, task_field field) const -> bool
+{
+    return present_[index] & (1u << std::to_underlying(field));
+}
+
+auto task_store::headers(size_type index) const -> const attributes_type&
+{
+    return headers_[index];
+}
+
+auto task_store::bodies(size_type index) const -> const attributes_type&
+{
+    return bodies_[index];
+}
+
+auto task_store::get_id(size_type index) const -> task_id
+{
+    if (contains(index, task_field::task_id))
+        return ids_[index];
+
+    auto attr = find(headers_[index], keys::task_id);
+    return task_id::from_string(attr ? std::string_view(attr->second) : std::string_view{});
+}
+
+auto task_store::set_id(size_type index, task_id id) -> void
+{
+    auto key = keys::task_id;
+    auto idx = find_index(key);
+    if (idx)
+        unindex(*idx, index, get_header(index, key));
+
+    ids_[index] = id;
+    set_present(index, task_field::task_id, true);
+    erase(headers_[index], key);
+
+    if (idx)
+        (*idx)[get_header(index, key)].insert(index);
+}
+
+auto task_store::get_text(size_type index, task_field field) const -> const std::string&
+{
+    return texts_[text_column(field)][index];
+}
+
+auto task_store::get_number(size_type index, task_field field) const -> double
+{
+    return numbers_[number_column(field)][index];
+}
+
+auto task_store::set_number(size_type index, task_field field, double value) -> void
+{
+    auto key = attribute_key(field);
+    auto idx = find_index(key);
+    if (idx)
+        unindex(*idx, index, get_header(index, key));
+
+    numbers_[number_column(field)][index] = value;
+    set_present(index, field, true);
+    erase(headers_[index], key);
+
+    if (idx)
+        (*idx)[get_header(index, key)].insert(index);
+    if (field == task_field::status)
+        this->update_pending(index);
+}
+
+auto task_store::to_json(size_type index) const -> json
+{
+    json item;
+    item["header"] = json::object();
+    for (std::size_t i = 0; i < task_field_names.size(); ++i) {
+        auto field = static_cast<task_field>(i);
+        if (contains(index, field))
+            item["header"][task_field_names[i]] = get_header(index, task_field_names[i]);
+    }
+
+    for (const auto& [key, value] : headers_[index])
+        item["header"][key] = value;
+
+    for (const auto& [key, value] : bodies_[index])
+        item["body"][key] = value;
+
+    return item;
+}
+
+auto task_store::create_index(attribute_key key) -> void
+{
+    if (has_index(key))
+        return;
+
+    auto& [name, idx] = indexes_.emplace_back(attribute_key::intern(key.name()), index_type{});
+    for (size_type i = 0; i < size(); ++i)
+        idx[get_header(i, key)].insert(i);
+}
+
+auto task_store::has_index(attribute_key key) const noexcept -> bool
+{
+    return std::ranges::find(indexes_, key.name(), [](const auto& item) { return item.first.name(); }) != indexes_.end();
+}
+
+auto task_store::lookup(attribute_key key, std::string_view value) const -> const bucket_type*
+{
+    static const bucket_type empty_bucket;
+
+    if (key.is(task_field::status) && value == "0")
+        return &pending_;
+
+    auto it = std::ranges::find(indexes_, key.name(), [](const auto& item) { return item.first.name(); });
+    if (it == indexes_.end())
+        return nullptr;
+
+    auto bucket = it->second.find(std::string(value));
+    return bucket != it->second.end() ? &bucket->second : &empty_bucket;
+}
+
+auto task_store::pending() const noexcept -> const bucket_type&
+{
+    return pending_;
+}
+
+auto task_store::field_of(std::string_view key) noexcept -> std::optional<task_field>
+{
+    return attribute_key::resolve(key);
+}
+
+auto task_store::format_number(double value) -> std::string
+{
+    // Shortest representation that round-trips through std::stod.
+    char buffer[32];
+    auto [ptr, ec] = std::to_chars(std::begin(buffer), std::end(buffer), value);
+    return std::string(buffer, ptr);
+}
+
+auto task_store::set_present(size_type index, task_field field, bool present) -> void
+{
+    auto bit = static_cast<std::uint16_t>(1u << std::to_underlying(field));
+    if (present)
+        present_[index] |= bit;
+    else
+        present_[index] &= ~bit;
+}
+
+auto task_store::find_index(attribute_key key) -> index_type*
+{
+    if (indexes_.empty())
+        return nullptr;
+
+    auto it = std::ranges::find(indexes_, key.name(), [](const auto& item) { return item.first.name(); });
+    return it != indexes_.end() ? &it->second : nullptr;
+}
+
+auto task_store::index_row(size_type index) -> void
+{
+    for (auto& [key, idx] : indexes_)
+        idx[get_header(index, key)].insert(index);
+    this->update_pending(index);
+}
+
+auto task_store::update_pending(size_type index) -> void
+{
+    if (contains(index, task_field::status) && numbers_[number_column(task_field::status)][index] == 0)
+        pending_.insert(index);
+    else
+        pending_.erase(index);
+}
+
+auto task_store::unindex(index_type& idx, size_type index, const std::string& value) -> void
+{
+    if (auto bucket = idx.find(value); bucket != idx.end()) {
+        bucket->second.erase(index);
+        if (bucket->second.empty())
+            idx.erase(bucket);
+    }
+}
+
+auto task_store::text_column(task_field field) noexcept -> std::size_t
+{
+    return std::to_underlying(field) - std::to_underlying(task_field::group);
+}
+
+auto task_store::number_column(task_field field) noexcept -> std::size_t
+{
+    return std::to_underlying(field) - std::to_underlying(task_field::cpu);
+}
+
+auto task_store::find(const attributes_type& attrs, std::string_view key) -> const attribute_type*
+{
+    auto it = std::ranges::find(attrs, key, &attribute_type::first);
+    return it != attrs.end() ? &*it : nullptr;
+}
+
+auto task_store::assign(attributes_type& attrs, std::string_view key, std::string_view value) -> void
+{
+    if (auto it = std::ranges::find(attrs, key, &attribute_type::first); it != attrs.end())
+        it->second = value;
+    else
+        attrs.emplace_back(key, value);
+}
+
+auto task_store::erase(attributes_type& attrs, std::string_view key) -> void
+{
+    std::erase_if(attrs, [key](const attribute_type& attr) { return attr.first == key; });
+}
+
+
+} // namespace okec
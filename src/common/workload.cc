@@ -0,0 +1,194 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/common/workload.h>
+#include <cmath>
+#include <numbers>
+
+
+namespace okec
+{
+
+namespace {
+
+class workload_source : public task_source
+{
+public:
+    workload_source(workload_generator generator, std::size_t n)
+        : generator_{ std::move(generator) }
+        , remaining_{ n }
+    {
+    }
+
+    auto read(task& t, std::size_t n) -> std::size_t override
+    {
+        n = std::min(n, remaining_);
+        generator_.generate(t, n);
+        remaining_ -= n;
+        return n;
+    }
+
+private:
+    workload_generator generator_;
+    std::size_t remaining_;
+};
+
+} // namespace
+
+
+workload_generator::workload_generator(std::uint64_t seed)
+    : engine_{ seed }
+{
+}
+
+auto workload_generator::uniform(std::string_view key, double low, double high, int precision) -> workload_generator&
+{
+    add(key, kind::uniform, low, high, precision);
+    return *this;
+}
+
+auto workload_generator::uniform_int(std::string_view key, std::int64_t low, std::int64_t high) -> workload_generator&
+{
+    add(key, kind::uniform_int, static_cast<double>(low), static_cast<double>(high), -1);
+    return *this;
+}
+
+auto workload_generator::exponential(std::string_view key, double mean, int precision) -> workload_generator&
+{
+    add(key, kind::exponential, mean, 0, precision);
+    return *this;
+}
+
+auto workload_generator::normal(std::string_view key, double mean, double stddev, int precision) -> workload_generator&
+{
+    add(key, kind::normal, mean, stddev, precision);
+    return *this;
+}
+
+auto workload_generator::constant(std::string_view key, std::string_view value) -> workload_generator&
+{
+    add(key, kind::constant, 0, 0, -1).text = value;
+    return *this;
+}
+
+auto workload_generator::custom(std::string_view key, distribution_type distribution, int precision) -> workload_generator&
+{
+    add(key, kind::custom, 0, 0, precision).distribution = std::move(distribution);
+    return *this;
+}
+
+auto workload_generator::generate(task& t, std::size_t n) -> void
+{
+    auto& store = t.store();
+    auto first = store.append(n);
+
+    for (auto index = first; index < first + n; ++index) {
+        if (!has_id_) {
+            auto high = engine_();
+            store.set_id(index, task_id(high, engine_()));
+        }
+
+        for (auto& attr : attributes_) {
+            if (attr.type == kind::constant) {
+                store.set_header(index, attr.key, attr.text);
+                continue;
+            }
+
+            auto value = next(attr);
+            if (attr.field && is_numeric_field(*attr.field))
+                store.set_number(index, *attr.field, value);
+            else
+                store.set_header(index, attr.key, task_store::format_number(value));
+        }
+    }
+}
+
+auto workload_generator::generate(std::size_t n) -> task
+{
+    task t;
+    this->generate(t, n);
+    return t;
+}
+
+auto workload_generator::source(std::size_t n) const -> std::shared_ptr<task_source>
+{
+    return std::make_shared<workload_source>(*this, n);
+}
+
+auto workload_generator::add(std::string_view key, kind type, double a, double b, int precision) -> attribute&
+{
+    if (key == task_field_names[std::to_underlying(task_field::task_id)])
+        has_id_ = true;
+
+    return attributes_.emplace_back(attribute{
+        .key = std::string(key),
+        .field = task_store::field_of(key),
+        .type = type,
+        .a = a,
+        .b = b,
+        .scale = precision < 0 ? 0 : std::pow(10.0, precision)
+    });
+}
+
+auto workload_generator::next(attribute& attr) -> double
+{
+    double value{};
+    switch (attr.type) {
+    case kind::uniform:
+        value = attr.a + (attr.b - attr.a) * next_canonical();
+        break;
+    case kind::uniform_int: {
+        auto range = static_cast<std::uint64_t>(attr.b - attr.a) + 1;
+        value = attr.a + static_cast<double>(next_bounded(range));
+        break;
+    }
+    case kind::exponential:
+        value = -attr.a * std::log1p(-next_canonical());
+        break;
+    case kind::normal: {
+        // Box-Muller, one of the pair is enough here
+        auto u1 = 1.0 - next_canonical();
+        auto u2 = next_canonical();
+        value = attr.a + attr.b * std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * std::numbers::pi * u2);
+        break;
+    }
+    case kind::custom:
+        value = attr.distribution(engine_);
+        break;
+    case kind::constant:
+        break;
+    }
+
+    return attr.scale ? std::round(value * attr.scale) / attr.scale : value;
+}
+
+auto workload_generator::next_bounded(std::uint64_t range) -> std::uint64_t
+{
+    // 拒绝 2^64 mod range 以下的值，取模后才是均匀的
+    // 不用 std::uniform_int_distribution，它的结果随标准库实现而不同
+    if (range == 0)
+        return engine_();
+
+    auto threshold = (0 - range) % range;
+    for (;;) {
+        auto r = engine_();
+        if (r >= threshold)
+            return r % range;
+    }
+}
+
+auto workload_generator::next_canonical() -> double
+{
+    // 53 random bits in [0, 1)
+    return static_cast<double>(engine_() >> 11) * 0x1.0p-53;
+}
+
+
+} // namespace okec
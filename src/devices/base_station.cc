@@ -40,9 +40,8 @@ base_station::base_station(simulator& sim)
 
 base_station::~base_station()
 {
-    // auto& task_sequence = this->task_sequence();
-    // if (!task_sequence.empty()) {
-    //     okec::print("任务列表还余{}任务未处理\n", task_sequence.size());
+    // if (!m_tasks.empty()) {
+    //     okec::print("任务列表还余{}任务未处理\n", m_tasks.size());
     // } else {
     //     okec::print("任务已全部完成\n");
     // }
@@ -127,34 +126,45 @@ auto base_station::write(ns3::Ptr<ns3::Packet> packet, ns3::Ipv4Address destinat
     m_udp_application->write(packet, destination, port);
 }
 
-auto base_station::task_sequence(const task_element& item) -> void
+auto base_station::tasks() noexcept -> task_queue&
 {
-    m_task_sequence.push_back(item);
-    m_task_sequence_status.push_back(0); // 0 means not dispatched.
+    return m_tasks;
 }
 
-auto base_station::task_sequence(task_element&& item) -> void
+auto base_station::submit_task(task_element item) -> std::optional<task_element>
 {
-    m_task_sequence.emplace_back(std::move(item));
-    m_task_sequence_status.push_back(0); // 0 means not dispatched.
+    auto waiting = m_dependencies.waiting();
+    auto failed = m_dependencies.submit(std::move(item), m_tasks);
+
+    if (m_dependencies.waiting() > waiting)
+        log::debug("base station({:ip}) holds a task until its predecessors complete.", this->get_address());
+
+    return failed;
+}
+
+auto base_station::complete_task(const task_id& id) -> std::size_t
+{
+    return m_dependencies.complete(id, m_tasks);
 }
 
-auto base_station::task_sequence() -> std::vector<task_element>&
+auto base_station::fail_task(const task_id& id) -> std::vector<task_element>
 {
-    return m_task_sequence;
+    return m_dependencies.fail(id);
 }
 
-auto base_station::task_sequence_status() -> std::vector<char>&
+auto base_station::fail_waiting_tasks() -> std::vector<task_element>
 {
-    return m_task_sequence_status;
+    return m_dependencies.take_waiting();
+}
+
+auto base_station::waiting_tasks() const -> std::size_t
+{
+    return m_dependencies.waiting();
 }
 
 auto base_station::print_task_info() -> void
 {
-    // okec::print("Task sequence size: {}\n", m_task_sequence.size());
-    // for (const auto& item : m_task_sequence) {
-    //     okec::print("Item: {}\n", item.dump());
-    // }
+    // okec::print("Task queue size: {}, ready: {}\n", m_tasks.size(), m_tasks.ready());
 }
 
 auto base_station::handle_next() -> void
@@ -189,7 +199,7 @@ auto base_station::handle_next() -> void
     //         msg.type(message_handling);
     //         msg.content(m_task_sequence[i]);
     //         print_info(okec::format("The base station([{:ip}]) dispatchs the task(task_id = {}) to {}",
-    //             this->get_address(), m_task_sequence[i].get_header("task_id"), target_ip));
+    //             this->get_address(), m_task_sequence[i].get_header(keys::task_id), target_ip));
     //         m_udp_application->write(msg.to_packet(), ns3::Ipv4Address(target_ip.c_str()), target_port);
 
     //         // 更改任务分发状态
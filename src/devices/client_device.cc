@@ -62,16 +62,59 @@ auto client_device::install_resource(ns3::Ptr<resource> res) -> void
 
 auto client_device::send(task t) -> void
 {
-    // 任务不能以 task 为单位发送，因为 task 可能会非常大，导致发送的数据断页，在目的端便无法恢复数据
-    // 以 task_element 为单位发送则可以避免 task 大小可能会带来的问题
+    // 超出单个数据报的消息由 udp_application 分片发送并在目的端重组
+    // 决策引擎按 task_element 决策，所以这里仍以 task_element 为单位发送
     // double launch_delay{ 1.0 };
+    m_decision_engine->prepare(t);
     for (auto&& item : t.elements_view()) {
         m_decision_engine->send(std::move(item), shared_from_this());
     }
 }
 
+auto client_device::send(std::shared_ptr<task_source> source, std::size_t chunk_size) -> void
+{
+    if (!source || !chunk_size)
+        return;
+
+    m_source = std::move(source);
+    m_chunk_size = chunk_size;
+    this->read_next_chunk();
+}
+
+auto client_device::set_arrival_process(std::shared_ptr<arrival_process> process) -> void
+{
+    m_arrival_process = std::move(process);
+}
+
+auto client_device::get_arrival_process() const -> std::shared_ptr<arrival_process>
+{
+    return m_arrival_process;
+}
+
+auto client_device::schedule_launch(const task_element& item, std::function<void()> launch) -> void
+{
+    auto now = ns3::Simulator::Now().GetSeconds();
+    if (!m_arrival_process) {
+        m_launches.emplace(now, std::move(launch));
+        this->arm_launch_event();
+        return;
+    }
+
+    // 已有任务在等待时排在其后，保持发出顺序
+    if (m_held.empty()) {
+        if (auto at = m_arrival_process->next(item, now)) {
+            m_launches.emplace(std::max(*at, now), std::move(launch));
+            this->arm_launch_event();
+            return;
+        }
+    }
+
+    m_held.emplace_back(item, std::move(launch));
+}
+
 auto client_device::async_send(task t) -> std::suspend_never
 {
+    m_decision_engine->prepare(t);
     for (auto&& item : t.elements_view()) {
         m_decision_engine->send(std::move(item), shared_from_this());
     }
@@ -126,9 +169,14 @@ auto client_device::set_decision_engine(std::shared_ptr<decision_engine> engine)
 
 auto client_device::set_request_handler(std::string_view msg_type, callback_type callback) -> void
 {
+    bool is_response = msg_type == message_response;
     m_udp_application->set_request_handler(msg_type, 
-        [callback, this](ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) {
+        [callback, is_response, this](ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) {
             callback(this, packet, remote_address);
+
+            // 任务完成，闭环到达过程可以发出下一个任务
+            if (is_response)
+                this->on_task_completed();
         });
 }
 
@@ -137,7 +185,7 @@ auto client_device::dispatch(std::string_view msg_type, ns3::Ptr<ns3::Packet> pa
     m_udp_application->dispatch(msg_type, packet, address);
 }
 
-auto client_device::response_cache() -> response_type&
+auto client_device::response_cache() -> response_tracker&
 {
     return m_response;
 }
@@ -157,6 +205,92 @@ auto client_device::write(ns3::Ptr<ns3::Packet> packet, ns3::Ipv4Address destina
     m_udp_application->write(packet, destination, port);
 }
 
+auto client_device::arm_launch_event() -> void
+{
+    if (m_launches.empty())
+        return;
+
+    // 每个客户端只保留一个事件，同一时刻到达的任务在一个事件中成批发出
+    auto at = m_launches.begin()->first;
+    if (!m_launch_event.IsExpired()) {
+        if (m_launch_event_time <= at)
+            return;
+        m_launch_event.Cancel();
+    }
+
+    auto now = ns3::Simulator::Now().GetSeconds();
+    m_launch_event_time = at;
+    m_launch_event = ns3::Simulator::Schedule(ns3::Seconds(std::max(.0, at - now)), [self = shared_from_this()]() {
+        self->run_launches();
+    });
+}
+
+auto client_device::run_launches() -> void
+{
+    auto now = ns3::Simulator::Now().GetSeconds();
+    m_launch_event_time = -1.0;
+
+    while (!m_launches.empty() && m_launches.begin()->first <= now) {
+        auto launch = std::move(m_launches.begin()->second);
+        m_launches.erase(m_launches.begin());
+        launch();
+    }
+
+    this->arm_launch_event();
+
+    if (m_launches.empty() && m_held.empty())
+        this->read_next_chunk();
+}
+
+auto client_device::release_held() -> void
+{
+    auto now = ns3::Simulator::Now().GetSeconds();
+    while (!m_held.empty()) {
+        auto at = m_arrival_process ? m_arrival_process->next(m_held.front().first, now) : std::optional<double>{ now };
+        if (!at)
+            break;
+
+        m_launches.emplace(std::max(*at, now), std::move(m_held.front().second));
+        m_held.pop_front();
+    }
+
+    this->arm_launch_event();
+}
+
+auto client_device::on_task_completed() -> void
+{
+    if (m_arrival_process)
+        m_arrival_process->completed(ns3::Simulator::Now().GetSeconds());
+
+    this->release_held();
+}
+
+auto client_device::read_next_chunk() -> void
+{
+    if (!m_source || !m_decision_engine)
+        return;
+
+    task chunk;
+    auto count = m_source->read(chunk, m_chunk_size);
+    if (count < m_chunk_size)
+        m_source.reset();
+
+    // 优先级只根据当前块内的依赖关系计算
+    m_decision_engine->prepare(chunk);
+
+    // elements() 共享同一份快照，决策引擎可以安全地持有它们
+    for (auto&& item : chunk.elements()) {
+        m_decision_engine->send(std::move(item), shared_from_this());
+    }
+
+    // 决策引擎没有经由 schedule_launch 发出任务时，下一块不会被触发
+    if (m_source && m_launches.empty() && m_held.empty()) {
+        ns3::Simulator::ScheduleNow([self = shared_from_this()]() {
+            self->read_next_chunk();
+        });
+    }
+}
+
 auto client_device_container::operator[](std::size_t index) -> pointer_type
 {
     return this->get_device(index);
@@ -108,6 +108,8 @@ auto cloud_server::on_get_resource_information(ns3::Ptr<ns3::Packet> packet, con
     message msg {
         { "msgtype", "resource_information" },
         { "device_type", "cs" },
+        { "ip", okec::format("{:ip}", this->get_address()) },
+        { "port", okec::format("{}", this->get_port()) },
         { "pos_x", okec::format("{}", get_position().x) },
         { "pos_y", okec::format("{}", get_position().y) },
         { "pos_z", okec::format("{}", get_position().z) }
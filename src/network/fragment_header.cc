@@ -0,0 +1,123 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/network/fragment_header.h>
+#include <ostream>
+
+
+namespace okec
+{
+
+auto fragment_header::GetTypeId() -> ns3::TypeId
+{
+    static ns3::TypeId tid = ns3::TypeId("okec::fragment_header")
+                        .SetParent<ns3::Header>()
+                        .AddConstructor<fragment_header>();
+    return tid;
+}
+
+auto fragment_header::GetInstanceTypeId() const -> ns3::TypeId
+{
+    return fragment_header::GetTypeId();
+}
+
+auto fragment_header::GetSerializedSize() const -> uint32_t
+{
+    return size;
+}
+
+auto fragment_header::Serialize(ns3::Buffer::Iterator start) const -> void
+{
+    start.WriteHtonU16(magic);
+    start.WriteU8(version);
+    start.WriteU8(0);
+    start.WriteHtonU32(sequence_);
+    start.WriteHtonU16(index_);
+    start.WriteHtonU16(count_);
+    start.WriteHtonU32(message_size_);
+}
+
+auto fragment_header::Deserialize(ns3::Buffer::Iterator start) -> uint32_t
+{
+    valid_ = start.ReadNtohU16() == magic;
+    valid_ = start.ReadU8() == version && valid_;
+    start.ReadU8();
+    sequence_ = start.ReadNtohU32();
+    index_ = start.ReadNtohU16();
+    count_ = start.ReadNtohU16();
+    message_size_ = start.ReadNtohU32();
+    valid_ = valid_ && count_ > 0 && index_ < count_;
+    return size;
+}
+
+auto fragment_header::Print(std::ostream& os) const -> void
+{
+    os << "seq=" << sequence_
+       << " fragment=" << index_ << "/" << count_
+       << " size=" << message_size_;
+}
+
+auto fragment_header::sequence() const noexcept -> std::uint32_t
+{
+    return sequence_;
+}
+
+auto fragment_header::sequence(std::uint32_t seq) noexcept -> void
+{
+    sequence_ = seq;
+}
+
+auto fragment_header::index() const noexcept -> std::uint16_t
+{
+    return index_;
+}
+
+auto fragment_header::index(std::uint16_t i) noexcept -> void
+{
+    index_ = i;
+}
+
+auto fragment_header::count() const noexcept -> std::uint16_t
+{
+    return count_;
+}
+
+auto fragment_header::count(std::uint16_t n) noexcept -> void
+{
+    count_ = n;
+}
+
+auto fragment_header::message_size() const noexcept -> std::uint32_t
+{
+    return message_size_;
+}
+
+auto fragment_header::message_size(std::uint32_t n) noexcept -> void
+{
+    message_size_ = n;
+}
+
+auto fragment_header::valid() const noexcept -> bool
+{
+    return valid_;
+}
+
+auto fragment_header::peek(ns3::Ptr<ns3::Packet> packet) -> std::optional<fragment_header>
+{
+    if (!packet || packet->GetSize() < size)
+        return std::nullopt;
+
+    fragment_header header;
+    packet->PeekHeader(header);
+    return header.valid() ? std::optional<fragment_header>{ header } : std::nullopt;
+}
+
+
+} // namespace okec
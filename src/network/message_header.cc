@@ -0,0 +1,135 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/network/message_header.h>
+#include <okec/common/attribute_key.h>
+#include <ostream>
+
+
+namespace okec
+{
+
+auto message_header::GetTypeId() -> ns3::TypeId
+{
+    static ns3::TypeId tid = ns3::TypeId("okec::message_header")
+                        .SetParent<ns3::Header>()
+                        .AddConstructor<message_header>();
+    return tid;
+}
+
+auto message_header::GetInstanceTypeId() const -> ns3::TypeId
+{
+    return message_header::GetTypeId();
+}
+
+auto message_header::GetSerializedSize() const -> uint32_t
+{
+    return size;
+}
+
+auto message_header::Serialize(ns3::Buffer::Iterator start) const -> void
+{
+    start.WriteHtonU16(magic);
+    start.WriteU8(version);
+    start.WriteU8(std::to_underlying(encoding_));
+    start.WriteHtonU16(std::to_underlying(type_));
+    start.WriteHtonU16(0);
+    start.WriteHtonU64(task_id_.high());
+    start.WriteHtonU64(task_id_.low());
+    start.WriteHtonU64(group_id_);
+}
+
+auto message_header::Deserialize(ns3::Buffer::Iterator start) -> uint32_t
+{
+    valid_ = start.ReadNtohU16() == magic;
+    valid_ = start.ReadU8() == version && valid_;
+    encoding_ = static_cast<packet_helper::encoding>(start.ReadU8());
+    type_ = static_cast<message_kind>(start.ReadNtohU16());
+    if (std::to_underlying(type_) >= std::to_underlying(message_kind::count))
+        type_ = message_kind::user;
+    start.ReadNtohU16();
+    auto high = start.ReadNtohU64();
+    auto low = start.ReadNtohU64();
+    task_id_ = task_id(high, low);
+    group_id_ = start.ReadNtohU64();
+    return size;
+}
+
+auto message_header::Print(std::ostream& os) const -> void
+{
+    auto name = message_kind_name(type_);
+    os << "type=" << (name.empty() ? std::string_view("user") : name)
+       << " task_id=" << task_id_.to_string()
+       << " group=" << group_id_
+       << " encoding=" << static_cast<int>(std::to_underlying(encoding_));
+}
+
+auto message_header::type() const noexcept -> message_kind
+{
+    return type_;
+}
+
+auto message_header::type(message_kind kind) noexcept -> void
+{
+    type_ = kind;
+}
+
+auto message_header::encoding() const noexcept -> packet_helper::encoding
+{
+    return encoding_;
+}
+
+auto message_header::encoding(packet_helper::encoding e) noexcept -> void
+{
+    encoding_ = e;
+}
+
+auto message_header::get_task_id() const noexcept -> task_id
+{
+    return task_id_;
+}
+
+auto message_header::set_task_id(task_id id) noexcept -> void
+{
+    task_id_ = id;
+}
+
+auto message_header::group_id() const noexcept -> std::uint64_t
+{
+    return group_id_;
+}
+
+auto message_header::group_id(std::uint64_t id) noexcept -> void
+{
+    group_id_ = id;
+}
+
+auto message_header::valid() const noexcept -> bool
+{
+    return valid_;
+}
+
+auto message_header::peek(ns3::Ptr<ns3::Packet> packet) -> std::optional<message_header>
+{
+    if (!packet || packet->GetSize() < size)
+        return std::nullopt;
+
+    message_header header;
+    packet->PeekHeader(header);
+    return header.valid() ? std::optional<message_header>{ header } : std::nullopt;
+}
+
+auto message_header::hash_group(std::string_view group) noexcept -> std::uint64_t
+{
+    return attribute_key::fnv1a(group);
+}
+
+
+} // namespace okec
@@ -9,6 +9,8 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <okec/common/task.h>
+#include <okec/network/fragment_header.h>
+#include <okec/network/message_header.h>
 #include <okec/network/udp_application.h>
 #include <okec/utils/format_helper.hpp>
 #include <okec/utils/log.h>
@@ -44,7 +46,10 @@ namespace okec
 udp_application::udp_application()
     : m_port{ 8860 },
       m_recv_socket{ nullptr },
-      m_send_socket{ nullptr }
+      m_send_socket{ nullptr },
+      m_max_payload{ 1472 },
+      m_next_sequence{ 0 },
+      m_reassembly_timeout{ ns3::Seconds(1) }
 {
 }
 
@@ -72,24 +77,136 @@ auto udp_application::read_handler(ns3::Ptr<ns3::Socket> socket) -> void
     ns3::Address remote_address;
 
     while ((packet = socket->RecvFrom(remote_address))) {
-        auto content = packet_helper::to_string(packet);
-        log::debug("{:ip} has received a packet: \"{}\" size: {}", this->get_address(), content, content.size());
-        if (packet) {
-            auto msg_type = get_message_type(packet);
-            log::debug("{:ip} is processing [{}] message...", this->get_address(), msg_type);
-            auto dispatched = m_msg_handler.dispatch(msg_type, packet, remote_address);
-            NS_ASSERT_MSG(dispatched, "Invalid message type: " << msg_type);
+        // 分片的消息在收齐所有分片后才处理
+        if (fragment_header::peek(packet)) {
+            packet = this->reassemble(packet, remote_address);
+            if (!packet)
+                continue;
         }
+
+        this->handle_packet(packet, remote_address);
     }
 }
 
+auto udp_application::handle_packet(ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> void
+{
+    if (!packet)
+        return;
+
+    // 处理函数中创建的消息在返回时一次性释放
+    message_arena::scope arena;
+
+    // 消息类型优先从消息头中读取，无需解析消息体
+    auto kind = message_kind::user;
+    if (auto header = message_header::peek(packet)) {
+        packet->RemoveHeader(*header);
+        kind = header->type();
+    }
+
+    // 每个数据包最多解析一次，处理函数通过 packet_helper 复用解析结果
+    packet_helper::decoded_packet decoded(packet);
+    if (log::level_debug_enabled)
+        log::debug("{:ip} has received a packet: \"{}\" size: {}", this->get_address(), decoded.value().dump(), packet->GetSize());
+
+    if (kind != message_kind::user) {
+        log::debug("{:ip} is processing [{}] message...", this->get_address(), message_kind_name(kind));
+        auto dispatched = m_msg_handler.dispatch(kind, packet, remote_address);
+        NS_ASSERT_MSG(dispatched, "Invalid message type: " << message_kind_name(kind));
+        return;
+    }
+
+    auto msg_type = get_message_type(decoded.value());
+    log::debug("{:ip} is processing [{}] message...", this->get_address(), msg_type);
+    auto dispatched = m_msg_handler.dispatch(msg_type, packet, remote_address);
+    NS_ASSERT_MSG(dispatched, "Invalid message type: " << msg_type);
+}
+
+auto udp_application::reassemble(ns3::Ptr<ns3::Packet> packet, const ns3::Address& remote_address) -> ns3::Ptr<ns3::Packet>
+{
+    this->drop_expired_fragments();
+
+    fragment_header header;
+    packet->RemoveHeader(header);
+
+    auto sender = ns3::InetSocketAddress::ConvertFrom(remote_address);
+    auto key = reassembly_key{ sender.GetIpv4().Get(), sender.GetPort(), header.sequence() };
+    auto [it, inserted] = m_reassembly.try_emplace(key);
+    auto& buffer = it->second;
+    if (inserted) {
+        buffer.fragments.resize(header.count());
+        buffer.expires = ns3::Simulator::Now() + m_reassembly_timeout;
+    }
+
+    if (buffer.fragments.size() != header.count()) {
+        log::warning("{:ip} has received an inconsistent fragment (seq: {}), message dropped", this->get_address(), header.sequence());
+        m_reassembly.erase(it);
+        return nullptr;
+    }
+
+    auto& slot = buffer.fragments[header.index()];
+    if (!slot) {
+        slot = packet;
+        ++buffer.received;
+    }
+
+    if (buffer.received < header.count())
+        return nullptr;
+
+    auto message = buffer.fragments.front();
+    for (std::size_t i = 1; i < buffer.fragments.size(); ++i)
+        message->AddAtEnd(buffer.fragments[i]);
+    m_reassembly.erase(it);
+
+    if (message->GetSize() != header.message_size()) {
+        log::warning("{:ip} has reassembled a message of {} bytes, expected {}, message dropped", this->get_address(), message->GetSize(), header.message_size());
+        return nullptr;
+    }
+
+    return message;
+}
+
+auto udp_application::drop_expired_fragments() -> void
+{
+    auto now = ns3::Simulator::Now();
+    std::erase_if(m_reassembly, [&](const auto& item) {
+        if (item.second.expires > now)
+            return false;
+
+        log::warning("{:ip} has dropped an incomplete message (seq: {}, {}/{} fragments)", this->get_address(),
+            std::get<2>(item.first), item.second.received, item.second.fragments.size());
+        return true;
+    });
+}
+
 auto udp_application::write(ns3::Ptr<ns3::Packet> packet, ns3::Ipv4Address destination, uint16_t port) -> void
 {
     log::debug("{:ip}:{} ---> {:ip}:{}", this->get_address(), this->get_port(), ns3::Ipv4Address::ConvertFrom(destination), port);
     // NS_LOG_FUNCTION (this << packet << destination << port);
     
-    m_send_socket->Connect(ns3::InetSocketAddress(destination, port));
-    m_send_socket->Send(packet);
+    // 发送套接字不做 Connect，每个数据包直接指定目的地址，避免每次发送都重新连接
+    auto remote = ns3::InetSocketAddress(destination, port);
+    if (packet->GetSize() <= m_max_payload) {
+        m_send_socket->SendTo(packet, 0, remote);
+        return;
+    }
+
+    // 超出单个数据报的消息按序号分片发送，由接收端重组
+    auto chunk = m_max_payload - fragment_header::size;
+    auto total = packet->GetSize();
+    auto count = (total + chunk - 1) / chunk;
+    NS_ASSERT_MSG(count <= UINT16_MAX, "Message too large: " << total << " bytes");
+
+    fragment_header header;
+    header.sequence(m_next_sequence++);
+    header.count(static_cast<uint16_t>(count));
+    header.message_size(total);
+    for (uint32_t i = 0; i < count; ++i) {
+        auto offset = i * chunk;
+        auto fragment = packet->CreateFragment(offset, std::min(chunk, total - offset));
+        header.index(static_cast<uint16_t>(i));
+        fragment->AddHeader(header);
+        m_send_socket->SendTo(fragment, 0, remote);
+    }
 }
 
 auto udp_application::get_address() -> ns3::Ipv4Address const
@@ -109,7 +226,28 @@ auto udp_application::set_request_handler(std::string_view msg_type, callback_ty
 
 auto udp_application::dispatch(std::string_view msg_type, ns3::Ptr<ns3::Packet> packet, const ns3::Address& address) -> void
 {
-    m_msg_handler.dispatch(msg_type.data(), packet, address);
+    m_msg_handler.dispatch(msg_type, packet, address);
+}
+
+auto udp_application::set_max_payload(uint32_t size) -> void
+{
+    NS_ASSERT_MSG(size > fragment_header::size, "Payload too small: " << size);
+    m_max_payload = size;
+}
+
+auto udp_application::get_max_payload() const -> uint32_t
+{
+    return m_max_payload;
+}
+
+auto udp_application::set_reassembly_timeout(ns3::Time timeout) -> void
+{
+    m_reassembly_timeout = timeout;
+}
+
+auto udp_application::get_reassembly_timeout() const -> ns3::Time
+{
+    return m_reassembly_timeout;
 }
 
 auto udp_application::StartApplication() -> void
@@ -126,6 +264,8 @@ auto udp_application::StartApplication() -> void
     m_recv_socket->SetRecvCallback(MakeCallback(&udp_application::read_handler, this));
 
     m_send_socket = ns3::Socket::CreateSocket(GetNode(), tid);
+    if (m_send_socket->Bind() == -1)
+        log::error("Failed to bind send socket");
 }
 
 auto udp_application::StopApplication() -> void
@@ -0,0 +1,127 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/utils/arena.h>
+#include <algorithm>
+#include <memory>
+#include <new>
+
+
+namespace okec
+{
+
+namespace {
+
+constexpr std::size_t block_size = 16 * 1024;
+constexpr std::size_t large_size = block_size / 4; // larger requests go to the heap
+constexpr std::size_t max_spare_blocks = 8;
+
+struct block
+{
+    std::unique_ptr<std::byte[]> data{ new std::byte[block_size] };
+    std::size_t used = 0;
+    std::size_t live = 0; // allocations not freed yet
+
+    auto owns(const void* p) const noexcept -> bool {
+        auto b = static_cast<const std::byte*>(p);
+        return b >= data.get() && b < data.get() + block_size;
+    }
+};
+
+struct arena_state
+{
+    std::vector<std::unique_ptr<block>> active;  // blocks of the current scope, the last one is filled
+    std::vector<std::unique_ptr<block>> spare;   // empty, ready for reuse
+    std::vector<std::unique_ptr<block>> retired; // outlived their scope, freed once empty
+    int depth = 0;
+};
+
+thread_local arena_state state;
+
+auto find_block(std::vector<std::unique_ptr<block>>& blocks, const void* p) noexcept
+{
+    return std::ranges::find_if(blocks, [p](const auto& b) { return b->owns(p); });
+}
+
+} // namespace
+
+
+message_arena::scope::scope() noexcept
+{
+    ++state.depth;
+}
+
+message_arena::scope::~scope()
+{
+    if (--state.depth > 0)
+        return;
+
+    for (auto& b : state.active) {
+        if (b->live > 0) {
+            state.retired.push_back(std::move(b));
+        } else if (state.spare.size() < max_spare_blocks) {
+            b->used = 0;
+            state.spare.push_back(std::move(b));
+        }
+    }
+    state.active.clear();
+}
+
+auto message_arena::allocate(std::size_t size, std::size_t alignment) -> void*
+{
+    if (state.depth == 0 || size > large_size)
+        return ::operator new(size);
+
+    auto fits = [&](const block& b) {
+        return (b.used + alignment - 1) / alignment * alignment + size <= block_size;
+    };
+
+    if (state.active.empty() || !fits(*state.active.back())) {
+        if (state.spare.empty()) {
+            state.active.push_back(std::make_unique<block>());
+        } else {
+            state.active.push_back(std::move(state.spare.back()));
+            state.spare.pop_back();
+        }
+    }
+
+    auto& b = *state.active.back();
+    auto offset = (b.used + alignment - 1) / alignment * alignment;
+    b.used = offset + size;
+    ++b.live;
+    return b.data.get() + offset;
+}
+
+auto message_arena::deallocate(void* p) noexcept -> void
+{
+    if (!p)
+        return;
+
+    if (auto it = find_block(state.active, p); it != state.active.end()) {
+        --(*it)->live;
+        return;
+    }
+
+    if (auto it = find_block(state.retired, p); it != state.retired.end()) {
+        if (--(*it)->live == 0)
+            state.retired.erase(it);
+        return;
+    }
+
+    ::operator delete(p);
+}
+
+auto message_arena::active() noexcept -> bool
+{
+    return state.depth > 0;
+}
+
+
+} // namespace okec
@@ -0,0 +1,392 @@
+///////////////////////////////////////////////////////////////////////////////
+//   __  __ _  ____  ___ 
+//  /  \(  / )(  __)/ __) OKEC(a.k.a. EdgeSim++)
+// (  O ))  (  ) _)( (__  version 1.0.1
+//  \__/(__\_)(____)\___) https://github.com/dxnu/okec
+// 
+// Copyright (C) 2023-2024 Gaoxing Li
+// Licenced under Apache-2.0 license. See LICENSE.txt for details.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <okec/utils/binary_table.h>
+#include <okec/common/resource.h>
+#include <okec/common/task.h>
+#include <okec/utils/json_helper.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#ifdef __linux__
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+
+namespace okec
+{
+
+namespace {
+
+constexpr auto align8(std::uint64_t n) noexcept -> std::uint64_t
+{
+    return (n + 7) & ~std::uint64_t{7};
+}
+
+constexpr auto presence_words(std::uint64_t rows) noexcept -> std::uint64_t
+{
+    return (rows + 63) / 64;
+}
+
+constexpr auto value_size(binary_table::column_kind kind) noexcept -> std::uint64_t
+{
+    switch (kind) {
+    case binary_table::column_kind::number: return sizeof(double);
+    case binary_table::column_kind::text:   return sizeof(std::uint32_t);
+    case binary_table::column_kind::id:     return 2 * sizeof(std::uint64_t);
+    }
+    return 0;
+}
+
+} // namespace
+
+
+binary_table::binary_table(const std::string& file_name)
+{
+#ifdef __linux__
+    int fd = ::open(file_name.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+
+    struct stat st;
+    if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* addr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            data_ = static_cast<const char*>(addr);
+            size_ = st.st_size;
+            mapped_ = true;
+        }
+    }
+    ::close(fd);
+#else
+    std::ifstream fin(file_name, std::ios::binary);
+    if (!fin.is_open())
+        return;
+
+    buffer_.assign(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#endif
+
+    if (!this->validate())
+        this->close();
+}
+
+binary_table::binary_table(binary_table&& other) noexcept
+    : data_{ std::exchange(other.data_, nullptr) }
+    , size_{ std::exchange(other.size_, 0) }
+    , buffer_{ std::move(other.buffer_) }
+    , mapped_{ std::exchange(other.mapped_, false) }
+{
+}
+
+binary_table& binary_table::operator=(binary_table&& other) noexcept
+{
+    if (this != &other) {
+        this->close();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        buffer_ = std::move(other.buffer_);
+        mapped_ = std::exchange(other.mapped_, false);
+    }
+
+    return *this;
+}
+
+binary_table::~binary_table()
+{
+    this->close();
+}
+
+auto binary_table::is_binary_file(const std::string& file_name) -> bool
+{
+    std::ifstream fin(file_name, std::ios::binary);
+    char buf[sizeof(magic)]{};
+    return fin.read(buf, sizeof(buf)) && std::memcmp(buf, magic, sizeof(magic)) == 0;
+}
+
+auto binary_table::is_open() const noexcept -> bool
+{
+    return data_ != nullptr;
+}
+
+auto binary_table::kind() const noexcept -> content_kind
+{
+    return static_cast<content_kind>(reinterpret_cast<const header_type*>(data_)->kind);
+}
+
+auto binary_table::rows() const noexcept -> std::size_t
+{
+    return is_open() ? reinterpret_cast<const header_type*>(data_)->row_count : 0;
+}
+
+auto binary_table::columns() const noexcept -> std::size_t
+{
+    return is_open() ? reinterpret_cast<const header_type*>(data_)->column_count : 0;
+}
+
+auto binary_table::column_name(std::size_t column) const -> std::string_view
+{
+    return string_at(column_at(column).name);
+}
+
+auto binary_table::get_column_kind(std::size_t column) const -> column_kind
+{
+    return static_cast<column_kind>(column_at(column).kind);
+}
+
+auto binary_table::column_section(std::size_t column) const -> std::uint8_t
+{
+    return column_at(column).section;
+}
+
+auto binary_table::has_value(std::size_t column, std::size_t row) const -> bool
+{
+    auto words = reinterpret_cast<const std::uint64_t*>(data_ + column_at(column).presence_offset);
+    return words[row / 64] & (std::uint64_t{1} << (row % 64));
+}
+
+auto binary_table::numbers(std::size_t column) const -> std::span<const double>
+{
+    return { reinterpret_cast<const double*>(data_ + column_at(column).data_offset), rows() };
+}
+
+auto binary_table::text(std::size_t column, std::size_t row) const -> std::string_view
+{
+    auto offsets = reinterpret_cast<const std::uint32_t*>(data_ + column_at(column).data_offset);
+    return string_at(offsets[row]);
+}
+
+auto binary_table::id(std::size_t column, std::size_t row) const -> task_id
+{
+    auto ids = reinterpret_cast<const std::uint64_t*>(data_ + column_at(column).data_offset);
+    return task_id(ids[2 * row], ids[2 * row + 1]);
+}
+
+auto binary_table::validate() const -> bool
+{
+    if (!data_ || size_ < sizeof(header_type))
+        return false;
+
+    auto header = reinterpret_cast<const header_type*>(data_);
+    if (std::memcmp(header->magic, magic, sizeof(magic)) != 0 || header->version != version)
+        return false;
+
+    if (header->strings_offset > size_ || header->strings_size > size_ - header->strings_offset)
+        return false;
+    if (header->strings_size == 0 || data_[header->strings_offset + header->strings_size - 1] != '\0')
+        return false;
+
+    auto columns_end = sizeof(header_type) + std::uint64_t{header->column_count} * sizeof(column_type);
+    if (columns_end > size_)
+        return false;
+
+    auto rows = header->row_count;
+    for (std::size_t i = 0; i < header->column_count; ++i) {
+        auto& col = column_at(i);
+        if (col.kind > std::to_underlying(column_kind::id) || col.name >= header->strings_size)
+            return false;
+
+        auto kind = static_cast<column_kind>(col.kind);
+        if (col.presence_offset % 8 || col.data_offset % 8)
+            return false;
+        if (col.presence_offset > size_ || presence_words(rows) * 8 > size_ - col.presence_offset)
+            return false;
+        if (rows && (col.data_offset > size_ || (size_ - col.data_offset) / value_size(kind) < rows))
+            return false;
+
+        if (kind == column_kind::text) {
+            auto offsets = reinterpret_cast<const std::uint32_t*>(data_ + col.data_offset);
+            if (std::any_of(offsets, offsets + rows, [&](auto offset) { return offset >= header->strings_size; }))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+auto binary_table::string_at(std::uint32_t offset) const -> std::string_view
+{
+    return data_ + reinterpret_cast<const header_type*>(data_)->strings_offset + offset;
+}
+
+auto binary_table::column_at(std::size_t column) const -> const column_type&
+{
+    return reinterpret_cast<const column_type*>(data_ + sizeof(header_type))[column];
+}
+
+auto binary_table::close() -> void
+{
+#ifdef __linux__
+    if (mapped_)
+        ::munmap(const_cast<char*>(data_), size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+    buffer_.clear();
+}
+
+
+binary_table_writer::binary_table_writer(binary_table::content_kind kind, std::size_t rows)
+    : kind_{ kind }
+    , rows_{ rows }
+{
+    strings_.push_back('\0'); // offset 0 is the empty string
+    string_offsets_.emplace(std::string{}, 0);
+}
+
+auto binary_table_writer::column(std::string_view name, column_kind kind, std::uint8_t section) -> std::size_t
+{
+    auto offset = intern(name);
+    auto it = std::ranges::find_if(columns_, [&](const column_data& col) {
+        return col.name == offset && col.kind == kind && col.section == section;
+    });
+    if (it != columns_.end())
+        return std::distance(columns_.begin(), it);
+
+    auto& col = columns_.emplace_back(column_data{ .name = offset, .kind = kind, .section = section });
+    col.presence.resize(presence_words(rows_));
+    switch (kind) {
+    case column_kind::number: col.numbers.resize(rows_); break;
+    case column_kind::text:   col.texts.resize(rows_); break;
+    case column_kind::id:     col.ids.resize(2 * rows_); break;
+    }
+
+    return columns_.size() - 1;
+}
+
+auto binary_table_writer::set_number(std::size_t column, std::size_t row, double value) -> void
+{
+    auto& col = columns_[column];
+    col.numbers[row] = value;
+    mark(col, row);
+}
+
+auto binary_table_writer::set_text(std::size_t column, std::size_t row, std::string_view value) -> void
+{
+    auto& col = columns_[column];
+    col.texts[row] = intern(value);
+    mark(col, row);
+}
+
+auto binary_table_writer::set_id(std::size_t column, std::size_t row, task_id value) -> void
+{
+    auto& col = columns_[column];
+    col.ids[2 * row] = value.high();
+    col.ids[2 * row + 1] = value.low();
+    mark(col, row);
+}
+
+auto binary_table_writer::save(const std::string& file_name) const -> bool
+{
+    std::ofstream fout(file_name, std::ios::binary | std::ios::trunc);
+    if (!fout.is_open())
+        return false;
+
+    std::vector<binary_table::column_type> descriptors;
+    descriptors.reserve(columns_.size());
+
+    std::uint64_t offset = align8(sizeof(binary_table::header_type) + columns_.size() * sizeof(binary_table::column_type));
+    for (const auto& col : columns_) {
+        auto& desc = descriptors.emplace_back();
+        desc.name = col.name;
+        desc.kind = std::to_underlying(col.kind);
+        desc.section = col.section;
+        desc.presence_offset = offset;
+        offset += presence_words(rows_) * sizeof(std::uint64_t);
+        desc.data_offset = offset;
+        offset = align8(offset + rows_ * value_size(col.kind));
+    }
+
+    binary_table::header_type header{};
+    std::memcpy(header.magic, binary_table::magic, sizeof(header.magic));
+    header.version = binary_table::version;
+    header.kind = std::to_underlying(kind_);
+    header.column_count = columns_.size();
+    header.row_count = rows_;
+    header.strings_offset = offset;
+    header.strings_size = strings_.size();
+
+    auto pad = [&fout]() {
+        static constexpr char zeros[8]{};
+        auto pos = static_cast<std::uint64_t>(fout.tellp());
+        fout.write(zeros, align8(pos) - pos);
+    };
+
+    fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    fout.write(reinterpret_cast<const char*>(descriptors.data()), descriptors.size() * sizeof(binary_table::column_type));
+    pad();
+    for (const auto& col : columns_) {
+        fout.write(reinterpret_cast<const char*>(col.presence.data()), col.presence.size() * sizeof(std::uint64_t));
+        switch (col.kind) {
+        case column_kind::number:
+            fout.write(reinterpret_cast<const char*>(col.numbers.data()), col.numbers.size() * sizeof(double));
+            break;
+        case column_kind::text:
+            fout.write(reinterpret_cast<const char*>(col.texts.data()), col.texts.size() * sizeof(std::uint32_t));
+            break;
+        case column_kind::id:
+            fout.write(reinterpret_cast<const char*>(col.ids.data()), col.ids.size() * sizeof(std::uint64_t));
+            break;
+        }
+        pad();
+    }
+    fout.write(strings_.data(), strings_.size());
+
+    return static_cast<bool>(fout);
+}
+
+auto binary_table_writer::intern(std::string_view value) -> std::uint32_t
+{
+    auto [it, inserted] = string_offsets_.try_emplace(std::string(value), static_cast<std::uint32_t>(strings_.size()));
+    if (inserted) {
+        strings_.append(value);
+        strings_.push_back('\0');
+    }
+
+    return it->second;
+}
+
+auto binary_table_writer::mark(column_data& col, std::size_t row) -> void
+{
+    col.presence[row / 64] |= std::uint64_t{1} << (row % 64);
+}
+
+
+auto convert_to_binary(const std::string& json_file, const std::string& binary_file) -> bool
+{
+    std::ifstream fin(json_file);
+    if (!fin.is_open())
+        return false;
+
+    json data = json::parse(fin, nullptr, false);
+    if (data.is_discarded())
+        return false;
+
+    if (json_helper::contains(data, "task", "items"))
+        return task(std::move(data)).save_to_binary_file(binary_file);
+
+    if (json_helper::contains(data, "resource", "items")) {
+        auto& items = data["resource"]["items"];
+        resource_container resources(items.size());
+        for (std::size_t i = 0; i < items.size(); ++i)
+            resources[i]->set_data(std::move(items[i]));
+        return resources.save_to_binary_file(binary_file);
+    }
+
+    return false;
+}
+
+
+} // namespace okec
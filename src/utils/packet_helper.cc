@@ -11,33 +11,175 @@
 #include <okec/common/response.h>
 #include <okec/common/task.h>
 #include <okec/utils/packet_helper.h>
+#include <span>
+#include <vector>
 
 
 namespace okec {
 namespace packet_helper {
 
 
+namespace {
+
+encoding wire_encoding = encoding::text;
+
+decoded_packet* current_packet = nullptr;
+
+// json packets always hold an object, whose first byte tells the format apart.
+auto encoding_of(std::uint8_t first) noexcept -> encoding
+{
+    if ((first >= 0x80 && first <= 0x8f) || first == 0xde || first == 0xdf)
+        return encoding::msgpack; // fixmap, map 16, map 32
+
+    if (first >= 0xa0 && first <= 0xbf)
+        return encoding::cbor; // major type 5
+
+    return encoding::text;
+}
+
+// Reused for every packet, so steady-state encoding and decoding does not allocate.
+thread_local std::vector<std::uint8_t> scratch;
+
+template <typename Json = json>
+auto decode(std::span<const std::uint8_t> buffer) -> Json
+{
+    // magic "OK" of a message_header that was not removed by the receiver
+    if (buffer.size() >= message_header_size && buffer[0] == 'O' && buffer[1] == 'K')
+        buffer = buffer.subspan(message_header_size);
+
+    if (buffer.empty())
+        return Json{};
+
+    Json j;
+    switch (encoding_of(buffer.front())) {
+    case encoding::msgpack:
+        j = Json::from_msgpack(buffer.begin(), buffer.end(), true, false);
+        break;
+    case encoding::cbor:
+        j = Json::from_cbor(buffer.begin(), buffer.end(), true, false);
+        break;
+    case encoding::text: {
+        auto last = buffer.end();
+        if (buffer.back() == '\0')
+            --last;
+        j = Json::parse(buffer.begin(), last, nullptr, false);
+        break;
+    }
+    }
+
+    return j.is_discarded() ? Json{} : j;
+}
+
+auto make_packet(const std::vector<std::uint8_t>& data) -> ns3::Ptr<ns3::Packet>
+{
+    return ns3::Create<ns3::Packet>(data.data(), data.size());
+}
+
+template <typename Json>
+auto encode(const Json& j) -> ns3::Ptr<ns3::Packet>
+{
+    switch (wire_encoding) {
+    case encoding::msgpack:
+        scratch.clear();
+        Json::to_msgpack(j, scratch);
+        return make_packet(scratch);
+    case encoding::cbor:
+        scratch.clear();
+        Json::to_cbor(j, scratch);
+        return make_packet(scratch);
+    default:
+        return packet_helper::make_packet(j.dump());
+    }
+}
+
+} // namespace
+
+
+auto set_encoding(encoding e) noexcept -> void
+{
+    wire_encoding = e;
+}
+
+auto get_encoding() noexcept -> encoding
+{
+    return wire_encoding;
+}
+
 auto make_packet(std::string_view sv) -> ns3::Ptr<ns3::Packet>
 {
     return ns3::Create<ns3::Packet>((uint8_t*)sv.data(), sv.length() + 1);
 }
 
+auto to_packet(const json& j) -> ns3::Ptr<ns3::Packet>
+{
+    return encode(j);
+}
+
+auto to_packet(const arena_json& j) -> ns3::Ptr<ns3::Packet>
+{
+    return encode(j);
+}
+
+auto payload_view(ns3::Ptr<ns3::Packet> packet) -> std::span<const std::uint8_t>
+{
+    scratch.resize(packet->GetSize());
+    packet->CopyData(scratch.data(), scratch.size());
+    return scratch;
+}
+
 auto to_string(ns3::Ptr<ns3::Packet> packet) -> std::string
 {
-    auto size = packet->GetSize();
-    auto buffer = new uint8_t[size];
-    packet->CopyData(buffer, size);
-    auto data = std::string(buffer, buffer + size);
-    delete[] buffer;
-    
-    return data;
+    auto buffer = payload_view(packet);
+    if (!buffer.empty() && encoding_of(buffer.front()) != encoding::text)
+        return decode(buffer).dump();
+
+    return std::string(buffer.begin(), buffer.end());
 }
 
 auto to_json(ns3::Ptr<ns3::Packet> packet) -> json
 {
-    json j;
-    auto data = to_string(packet);
-    return j.accept(data) ? j.parse(data) : j;
+    if (auto j = decoded_packet::find(packet))
+        return *j;
+
+    return decode(payload_view(packet));
+}
+
+auto to_arena_json(ns3::Ptr<ns3::Packet> packet) -> arena_json
+{
+    if (auto j = decoded_packet::find(packet))
+        return arena_json(*j);
+
+    return decode<arena_json>(payload_view(packet));
+}
+
+decoded_packet::decoded_packet(ns3::Ptr<ns3::Packet> packet)
+    : packet_{ packet }
+    , previous_{ current_packet }
+{
+    current_packet = this;
+}
+
+decoded_packet::~decoded_packet()
+{
+    current_packet = previous_;
+}
+
+auto decoded_packet::value() const -> const json&
+{
+    if (!value_)
+        value_.emplace(decode(payload_view(packet_)));
+
+    return *value_;
+}
+
+auto decoded_packet::find(ns3::Ptr<ns3::Packet> packet) -> const json*
+{
+    for (auto decoded = current_packet; decoded; decoded = decoded->previous_) {
+        if (ns3::PeekPointer(decoded->packet_) == ns3::PeekPointer(packet))
+            return &decoded->value();
+    }
+
+    return nullptr;
 }
 
 